@@ -106,6 +106,33 @@ b64dec_proc (struct b64state *state, void *buffer, size_t length,
 
   for (s=d=buffer; length && !state->stop_seen; length--, s++)
     {
+      if (ds == s_b64_0 && length >= 4)
+        {
+          /* Fast path: Decode complete quads of valid characters
+           * without going through the state machine.  Padding, white
+           * space and all other characters map to 0xff and end the
+           * fast path.  */
+          const unsigned char *p = (const unsigned char *)s;
+          unsigned int c0, c1, c2, c3;
+
+          while (length >= 4
+                 && !((p[0] | p[1] | p[2] | p[3]) & 0x80)
+                 && (c0 = asctobin[p[0]]) != 0xff
+                 && (c1 = asctobin[p[1]]) != 0xff
+                 && (c2 = asctobin[p[2]]) != 0xff
+                 && (c3 = asctobin[p[3]]) != 0xff)
+            {
+              *d++ = (c0 << 2) | (c1 >> 4);
+              *d++ = (c1 << 4) | (c2 >> 2);
+              *d++ = (c2 << 6) | c3;
+              p += 4;
+              length -= 4;
+            }
+          s = (char *)p;
+          if (!length)
+            break;
+        }
+
     again:
       switch (ds)
         {
@@ -197,6 +197,16 @@ my_fputs (const char *string, struct b64state *state)
 }
 
 
+static int
+my_fwrite (const char *buffer, size_t length, struct b64state *state)
+{
+  if (state->stream)
+    return es_write (state->stream, buffer, length, NULL)? EOF : 0;
+  else
+    return fwrite (buffer, length, 1, state->fp) != 1? EOF : 0;
+}
+
+
 /* Write NBYTES from BUFFER to the Base 64 stream identified by
    STATE. With BUFFER and NBYTES being 0, merely do a fflush on the
    stream. */
@@ -249,9 +259,36 @@ b64enc_write (struct b64state *state, const void *buffer, size_t nbytes)
       state->crc = (crc & 0x00ffffff);
     }
 
-  for (p=buffer; nbytes; p++, nbytes--)
+  for (p=buffer; nbytes; )
     {
-      radbuf[idx++] = *p;
+      if (!idx && nbytes >= 3)
+        {
+          /* Fast path: Encode all complete triples which fit into
+             the current line and write them at once.  */
+          char line[64+1];
+          size_t n = 0;
+
+          for (; nbytes >= 3 && quad_count < (64/4); p += 3, nbytes -= 3)
+            {
+              line[n++] = bintoasc[(p[0] >> 2) & 077];
+              line[n++] = bintoasc[(((p[0]<<4)&060)|((p[1] >> 4)&017))&077];
+              line[n++] = bintoasc[(((p[1]<<2)&074)|((p[2]>>6)&03))&077];
+              line[n++] = bintoasc[p[2]&077];
+              quad_count++;
+            }
+          if (quad_count >= (64/4))
+            {
+              quad_count = 0;
+              if (!(state->flags & B64ENC_NO_LINEFEEDS))
+                line[n++] = '\n';
+            }
+          if (my_fwrite (line, n, state) == EOF)
+            goto write_error;
+          continue;
+        }
+
+      radbuf[idx++] = *p++;
+      nbytes--;
       if (idx > 2)
         {
           char tmp[4];
@@ -45,6 +45,8 @@
 #  include <winsock2.h>
 # endif
 # include <windows.h>
+#else
+# include <sys/uio.h>
 #endif
 #ifdef __riscos__
 # include <kernel.h>
@@ -1332,6 +1334,13 @@ do_open (const char *fname, int special_filenames,
 	fp = direct_open (fname, opentype, mode700);
       if (fp == GNUPG_INVALID_FD)
 	return NULL;
+#if defined(HAVE_POSIX_FADVISE) && defined(POSIX_FADV_SEQUENTIAL)
+      /* Input files are read once from start to end.  Telling the
+         kernel so makes it read ahead more aggressively, so that the
+         next blocks arrive while we are processing the current one.  */
+      if (use == IOBUF_INPUT)
+        posix_fadvise (fp, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
     }
 
   a = iobuf_alloc (use, iobuf_buffer_size);
@@ -1797,6 +1806,26 @@ underflow (iobuf_t a, int clear_pending_eof)
 }
 
 
+/* The filter of A returned EOF.  Tell the filter to free itself and
+   release everything except for the internal buffer.  */
+static void
+filter_free_on_eof (iobuf_t a)
+{
+  size_t dummy_len = 0;
+  int rc;
+
+  if ((rc = a->filter (a->filter_ov, IOBUFCTRL_FREE, a->chain,
+                       NULL, &dummy_len)))
+    log_error ("IOBUFCTRL_FREE failed: %s\n", gpg_strerror (rc));
+
+  if (a->filter_ov && a->filter_ov_owner)
+    xfree (a->filter_ov);
+  a->filter_ov = NULL;
+  a->filter = NULL;
+  a->filter_eof = 1;
+}
+
+
 /****************
  * read underflow: read TARGET bytes into the buffer and return
  * the first byte or -1 on EOF.
@@ -1899,19 +1928,7 @@ underflow_target (iobuf_t a, int clear_pending_eof, size_t target)
       if (rc == -1)
 	/* EOF.  */
 	{
-	  size_t dummy_len = 0;
-
-	  /* Tell the filter to free itself */
-	  if ((rc = a->filter (a->filter_ov, IOBUFCTRL_FREE, a->chain,
-			       NULL, &dummy_len)))
-	    log_error ("IOBUFCTRL_FREE failed: %s\n", gpg_strerror (rc));
-
-	  /* Free everything except for the internal buffer.  */
-	  if (a->filter_ov && a->filter_ov_owner)
-	    xfree (a->filter_ov);
-	  a->filter_ov = NULL;
-	  a->filter = NULL;
-	  a->filter_eof = 1;
+	  filter_free_on_eof (a);
 
 	  if (clear_pending_eof && a->d.len == 0 && a->chain)
 	    /* We don't need to keep this filter around at all:
@@ -2034,7 +2051,7 @@ int
 iobuf_read (iobuf_t a, void *buffer, unsigned int buflen)
 {
   unsigned char *buf = (unsigned char *)buffer;
-  int c, n;
+  int c, n, rc;
 
   if (a->use == IOBUF_OUTPUT || a->use == IOBUF_OUTPUT_TEMP)
     {
@@ -2079,6 +2096,29 @@ iobuf_read (iobuf_t a, void *buffer, unsigned int buflen)
 	  if (buf)
 	    buf += size;
 	}
+      if (n < buflen && buf && buflen - n >= a->d.size
+          && a->d.start == a->d.len && a->use == IOBUF_INPUT
+          && a->filter && !a->filter_eof && !a->error)
+	/* The internal buffer is empty and the caller wants at least
+	   a full buffer.  Let the filter write directly into BUFFER
+	   instead of copying the data through our buffer.  */
+	{
+	  size_t len = a->d.size;
+
+	  rc = a->filter (a->filter_ov, IOBUFCTRL_UNDERFLOW, a->chain,
+			  buf, &len);
+	  if (DBG_IOBUF)
+	    log_debug ("iobuf-%d.%d: direct read returned rc=%d, %lu bytes\n",
+		       a->no, a->subno, rc, (ulong) len);
+	  n += len;
+	  buf += len;
+	  if (rc == -1)
+	    filter_free_on_eof (a);
+	  else if (rc)
+	    a->error = rc;
+	  if (rc || len)
+	    continue;
+	}
       if (n < buflen)
 	/* Draining the internal buffer didn't fill BUFFER.  Call
 	   underflow to read more data into the filter's internal
@@ -2166,6 +2206,110 @@ iobuf_writebyte (iobuf_t a, unsigned int c)
 }
 
 
+/* Return true if the filter of the output pipeline A is one of our
+   own filters which pass the data on without modifying the buffer
+   given to IOBUFCTRL_FLUSH.  */
+static int
+filter_keeps_buffer (iobuf_t a)
+{
+  return (a->filter == file_filter
+          || a->filter == file_es_filter
+#ifdef HAVE_W32_SYSTEM
+          || a->filter == sock_filter
+#endif
+          || a->filter == block_filter);
+}
+
+
+/* Flush BUFLEN bytes from BUF directly to the filter of A without
+   copying them to A's buffer first.  A's buffer must be empty.  The
+   partial length encoding of block_filter expects at most a buffer
+   full of data per call; thus we pass it the data in such chunks.  */
+static int
+filter_flush_direct (iobuf_t a, const byte *buf, size_t buflen)
+{
+  size_t len, chunk;
+  int rc = 0;
+
+  assert (!a->d.len);
+  if (DBG_IOBUF)
+    log_debug ("iobuf-%d.%d: flushing %lu bytes directly\n",
+	       a->no, a->subno, (ulong) buflen);
+
+  while (buflen)
+    {
+      chunk = buflen;
+      if (a->filter == block_filter && chunk > a->d.size)
+        chunk = a->d.size;
+      len = chunk;
+      rc = a->filter (a->filter_ov, IOBUFCTRL_FLUSH, a->chain,
+                      (byte *)buf, &len);
+      if (!rc && len != chunk)
+        {
+          log_info ("filter_flush did not write all!\n");
+          rc = GPG_ERR_INTERNAL;
+        }
+      if (rc)
+        {
+          a->error = rc;
+          break;
+        }
+      buf += chunk;
+      buflen -= chunk;
+    }
+
+  return rc;
+}
+
+
+#ifndef HAVE_W32_SYSTEM
+/* Write the data buffered in the file filter pipeline A followed by
+   BUFLEN bytes from BUF with a single writev.  This avoids copying
+   BUF into A's buffer and the extra write for what is left over.  */
+static int
+file_filter_writev (iobuf_t a, const byte *buf, size_t buflen)
+{
+  file_filter_ctx_t *fcx = a->filter_ov;
+  struct iovec iov[2];
+  int idx = 0;
+  ssize_t n;
+  int rc = 0;
+
+  iov[0].iov_base = a->d.buf;
+  iov[0].iov_len = a->d.len;
+  iov[1].iov_base = (void *)buf;
+  iov[1].iov_len = buflen;
+  if (DBG_IOBUF)
+    log_debug ("iobuf-%d.%d: writev %lu+%lu bytes\n",
+	       a->no, a->subno, (ulong) a->d.len, (ulong) buflen);
+
+  while (idx < 2)
+    {
+      n = writev (fcx->fp, iov + idx, 2 - idx);
+      if (n == -1)
+        {
+          if (errno == EINTR)
+            continue;
+          rc = gpg_error_from_syserror ();
+          log_error ("%s: write error: %s\n", fcx->fname, strerror (errno));
+          a->error = rc;
+          break;
+        }
+      while (idx < 2 && n >= iov[idx].iov_len)
+        n -= iov[idx++].iov_len;
+      if (idx < 2)
+        {
+          iov[idx].iov_base = (char *)iov[idx].iov_base + n;
+          iov[idx].iov_len -= n;
+        }
+    }
+  a->d.len = 0;
+
+  return rc;
+}
+#endif /*!HAVE_W32_SYSTEM*/
+
+
 int
 iobuf_write (iobuf_t a, const void *buffer, unsigned int buflen)
 {
@@ -2178,6 +2322,22 @@ iobuf_write (iobuf_t a, const void *buffer, unsigned int buflen)
       return -1;
     }
 
+  /* If nothing is buffered and the data would fill the entire
+     buffer anyway, we hand it straight to a filter which does not
+     modify it.  This saves one copy for each such stage.  */
+  if (a->use == IOBUF_OUTPUT && !a->d.len && buflen >= a->d.size
+      && a->filter && filter_keeps_buffer (a))
+    return filter_flush_direct (a, buf, buflen);
+
+#ifndef HAVE_W32_SYSTEM
+  /* Same as above but with a few bytes already buffered, typically
+     a partial length header written by the block filter.  Write
+     them together with the data in one system call.  */
+  if (a->use == IOBUF_OUTPUT && a->d.len && buflen >= a->d.size
+      && a->filter == file_filter)
+    return file_filter_writev (a, buf, buflen);
+#endif
+
   do
     {
       if (buflen && a->d.len < a->d.size)
@@ -2250,6 +2410,55 @@ iobuf_temp_to_buffer (iobuf_t a, byte * buffer, size_t buflen)
   return n;
 }
 
+#ifdef HAVE_COPY_FILE_RANGE
+/* If SOURCE and DEST are both plain files without any other filter,
+   let the kernel copy the data from SOURCE to DEST until EOF.
+   Returns the number of bytes copied this way, which is 0 if that is
+   not possible.  The caller needs to continue with a regular copy to
+   process the EOF or in case of an error.  */
+static size_t
+copy_file_direct (iobuf_t dest, iobuf_t source)
+{
+  file_filter_ctx_t *src, *dst;
+  ssize_t n;
+  size_t nwrote = 0;
+
+  if (source->use != IOBUF_INPUT || dest->use != IOBUF_OUTPUT
+      || source->chain || dest->chain
+      || source->filter != file_filter || dest->filter != file_filter
+      || source->nlimit || source->d.start < source->d.len
+      || source->filter_eof || source->error || dest->error)
+    return 0;
+  src = source->filter_ov;
+  dst = dest->filter_ov;
+  if (src->eof_seen || src->delayed_rc)
+    return 0;
+
+  /* Data already buffered in DEST (e.g. a packet header) must be
+     written before the copied data.  */
+  if (dest->d.len && filter_flush (dest))
+    return 0;
+
+  for (;;)
+    {
+      do
+        n = copy_file_range (src->fp, NULL, dst->fp, NULL,
+                             1024 * 1024 * 1024, 0);
+      while (n == -1 && errno == EINTR);
+      if (n <= 0)
+        break;
+      nwrote += n;
+    }
+
+  if (DBG_IOBUF)
+    log_debug ("iobuf-%d.%d: copied %lu bytes in the kernel\n",
+               source->no, source->subno, (ulong) nwrote);
+  source->nbytes += nwrote;
+  return nwrote;
+}
+#endif /*HAVE_COPY_FILE_RANGE*/
+
+
 /* Copies the data from the input iobuf SOURCE to the output iobuf
    DEST until either an error is encountered or EOF is reached.
    Returns the number of bytes copies.  */
@@ -2271,6 +2480,10 @@ iobuf_copy (iobuf_t dest, iobuf_t source)
   if (iobuf_error (dest))
     return -1;
 
+#ifdef HAVE_COPY_FILE_RANGE
+  nwrote = copy_file_direct (dest, source);
+#endif
+
   temp = xmalloc (temp_size);
   while (1)
     {
@@ -124,6 +124,7 @@ enum
 
     STATUS_PLAINTEXT,
     STATUS_PLAINTEXT_LENGTH,
+    STATUS_COMPRESS_STORED,
     STATUS_KEY_NOT_CREATED,
     STATUS_NEED_PASSPHRASE_PIN,
 
@@ -239,21 +239,17 @@ trim_trailing_spaces( char *string )
 unsigned
 trim_trailing_chars( byte *line, unsigned len, const char *trimchars )
 {
-    byte *p, *mark;
     unsigned n;
 
-    for(mark=NULL, p=line, n=0; n < len; n++, p++ ) {
-	if( strchr(trimchars, *p ) ) {
-	    if( !mark )
-		mark = p;
-	}
-	else
-	    mark = NULL;
-    }
+    /* Scan backwards so that only the trailing characters are
+       inspected; this is called for every line of a text mode
+       signature.  */
+    for (n=len; n && strchr (trimchars, line[n-1]); n--)
+      ;
 
-    if( mark ) {
-	*mark = 0;
-	return mark - line;
+    if( n < len ) {
+	line[n] = 0;
+	return n;
     }
     return len;
 }
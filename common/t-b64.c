@@ -19,7 +19,9 @@
 
 /*
 
-   As of now this is only a test program for manual tests.
+   Without arguments this runs the encoder and decoder on a range of
+   lengths and chunk sizes and compares the results against a
+   reference.  The other modes are for manual tests.
 
  */
 
@@ -40,6 +42,183 @@
 static int verbose;
 static int errcount;
 
+static const char ref_bintoasc[] =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+
+/* A straightforward base64 encoder used as reference.  Store the
+ * encoding of DATA at BUFFER with a linefeed after each 64
+ * characters and after a last partial line.  Return the length.  */
+static size_t
+ref_encode (const unsigned char *data, size_t length, char *buffer)
+{
+  char *p = buffer;
+  size_t i;
+  int col = 0;
+  unsigned int v;
+
+  for (i=0; i < length; i += 3)
+    {
+      v = data[i] << 16;
+      if (i + 1 < length)
+        v |= data[i+1] << 8;
+      if (i + 2 < length)
+        v |= data[i+2];
+      *p++ = ref_bintoasc[(v >> 18) & 63];
+      *p++ = ref_bintoasc[(v >> 12) & 63];
+      *p++ = i + 1 < length? ref_bintoasc[(v >> 6) & 63] : '=';
+      *p++ = i + 2 < length? ref_bintoasc[v & 63] : '=';
+      col += 4;
+      if (col == 64)
+        {
+          *p++ = '\n';
+          col = 0;
+        }
+    }
+  if (col)
+    *p++ = '\n';
+  return p - buffer;
+}
+
+
+/* The lengths and chunk sizes cross the 3 byte group, the 4
+ * character quad and the 48 byte (64 character) line boundaries.  */
+static const size_t test_lengths[] =
+  { 0, 1, 2, 3, 4, 5, 6, 45, 46, 47, 48, 49, 50, 51, 95, 96, 97,
+    99, 144, 145, 146, 1000 };
+static const size_t test_chunks[] =
+  { 1, 2, 3, 4, 5, 7, 47, 48, 49, 63, 64, 65, 96, 4096 };
+
+
+static void
+test_b64enc_chunks (void)
+{
+  static unsigned char data[1000];
+  static char expected[1400], result[1400];
+  gpg_error_t err;
+  struct b64state state;
+  estream_t fp;
+  size_t li, ci, i, n, explen, reslen;
+
+  for (i=0; i < sizeof data; i++)
+    data[i] = i * 7 + 3;
+
+  for (li=0; li < DIM (test_lengths); li++)
+    for (ci=0; ci < DIM (test_chunks); ci++)
+      {
+        explen = ref_encode (data, test_lengths[li], expected);
+
+        fp = es_fopenmem (0, "w+b");
+        if (!fp)
+          {
+            fail (0);
+            return;
+          }
+        err = b64enc_start_es (&state, fp, NULL);
+        if (err)
+          fail (1);
+        for (i=0; i < test_lengths[li]; i += n)
+          {
+            n = test_lengths[li] - i;
+            if (n > test_chunks[ci])
+              n = test_chunks[ci];
+            err = b64enc_write (&state, data + i, n);
+            if (err)
+              fail (2);
+          }
+        err = b64enc_finish (&state);
+        if (err)
+          fail (3);
+
+        es_rewind (fp);
+        if (es_read (fp, result, sizeof result, &reslen))
+          fail (4);
+        es_fclose (fp);
+
+        if (reslen != explen || memcmp (result, expected, explen))
+          {
+            if (verbose)
+              fprintf (stderr, "encoding length %u in chunks of %u\n",
+                       (unsigned int)test_lengths[li],
+                       (unsigned int)test_chunks[ci]);
+            fail (5);
+          }
+      }
+}
+
+
+/* Decode the reference encoding with and without linefeeds.  The
+ * version without linefeeds keeps the decoder in the quad fast path
+ * across chunk boundaries.  */
+static void
+test_b64dec_chunks (void)
+{
+  static unsigned char data[1000];
+  static char encoded[1400], buffer[1400], result[1000];
+  gpg_error_t err;
+  struct b64state state;
+  size_t li, ci, i, n, enclen, reslen, nbytes;
+  int nolf;
+  char *s, *d;
+
+  for (i=0; i < sizeof data; i++)
+    data[i] = i * 7 + 3;
+
+  for (nolf=0; nolf < 2; nolf++)
+    for (li=0; li < DIM (test_lengths); li++)
+      for (ci=0; ci < DIM (test_chunks); ci++)
+        {
+          enclen = ref_encode (data, test_lengths[li], encoded);
+          if (nolf)
+            {
+              for (s=d=encoded; s < encoded + enclen; s++)
+                if (*s != '\n')
+                  *d++ = *s;
+              enclen = d - encoded;
+            }
+
+          err = b64dec_start (&state, NULL);
+          if (err)
+            fail (1);
+          reslen = 0;
+          for (i=0; i < enclen; i += n)
+            {
+              n = enclen - i;
+              if (n > test_chunks[ci])
+                n = test_chunks[ci];
+              memcpy (buffer, encoded + i, n);
+              err = b64dec_proc (&state, buffer, n, &nbytes);
+              if (err)
+                {
+                  fail (2);
+                  break;
+                }
+              if (reslen + nbytes > sizeof result)
+                {
+                  fail (3);
+                  break;
+                }
+              memcpy (result + reslen, buffer, nbytes);
+              reslen += nbytes;
+            }
+          err = b64dec_finish (&state);
+          if (err)
+            fail (4);
+
+          if (reslen != test_lengths[li]
+              || memcmp (result, data, reslen))
+            {
+              if (verbose)
+                fprintf (stderr, "decoding length %u in chunks of %u%s\n",
+                         (unsigned int)test_lengths[li],
+                         (unsigned int)test_chunks[ci],
+                         nolf? " w/o linefeeds":"");
+              fail (5);
+            }
+        }
+}
+
+
 static void
 test_b64enc_pgp (const char *string)
 {
@@ -174,8 +353,13 @@ main (int argc, char **argv)
     test_b64enc_file (argc? *argv: NULL);
   else if (do_decode)
     test_b64dec_file (argc? *argv: NULL);
+  else if (argc)
+    test_b64enc_pgp (*argv);
   else
-    test_b64enc_pgp (argc? *argv: NULL);
+    {
+      test_b64enc_chunks ();
+      test_b64dec_chunks ();
+    }
 
   return !!errcount;
 }
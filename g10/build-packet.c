@@ -233,8 +233,10 @@ build_packet_and_meta (iobuf_t out, PACKET *pkt)
       rt.keyorg = pk->keyorg;
       rt.keyupdate = pk->keyupdate;
       rt.url = pk->updateurl;
+      rt.import_digest = pk->import_digest;
       err = do_ring_trust (out, &rt);
       rt.url = NULL;
+      rt.import_digest = NULL;
 
     }
 
@@ -409,6 +411,8 @@ do_ring_trust (iobuf_t out, PKT_ring_trust *rt)
       if (rt->url)
         namelen = strlen (rt->url);
       pktlen += 1 + 4 + 1 + namelen;
+      if (rt->subtype == RING_TRUST_KEY && rt->import_digest)
+        pktlen += 1 + IMPORT_DIGEST_LEN;
     }
 
   write_header (out, (0x80 | ((PKT_RING_TRUST & 15)<<2)), pktlen);
@@ -423,6 +427,13 @@ do_ring_trust (iobuf_t out, PKT_ring_trust *rt)
       iobuf_put (out, namelen);
       if (namelen)
         iobuf_write (out, rt->url, namelen);
+      /* The optional import digest is appended so that older
+       * versions simply skip it.  */
+      if (rt->subtype == RING_TRUST_KEY && rt->import_digest)
+        {
+          iobuf_put (out, IMPORT_DIGEST_LEN);
+          iobuf_write (out, rt->import_digest, IMPORT_DIGEST_LEN);
+        }
     }
 
   return 0;
@@ -253,12 +253,76 @@ write_final_chunk (cipher_filter_context_t *cfx, iobuf_t a)
 }
 
 
+/* Encrypt LEN bytes at DATA in place as part of the current chunk
+ * and write them to stream A.  If FINALIZE is set the chunk is
+ * finished and its tag written.  Unless FINALIZE is set LEN must be a
+ * multiple of the block size.  */
+static gpg_error_t
+encrypt_and_write (cipher_filter_context_t *cfx, iobuf_t a,
+                   byte *data, size_t len, int finalize)
+{
+  gpg_error_t err;
+
+  if (DBG_FILTER)
+    log_debug ("encrypting: len=%zu %s\n", len, finalize?"(finalize)":"");
+
+  if (!cfx->chunklen)
+    {
+      if (DBG_FILTER)
+        log_debug ("start encrypting a new chunk\n");
+      err = set_nonce_and_ad (cfx, 0);
+      if (err)
+        return err;
+    }
+
+  if (finalize)
+    gcry_cipher_final (cfx->cipher_hd);
+  if (DBG_FILTER)
+    {
+      if (finalize)
+        log_printhex (data, len, "plain(1):");
+      else if (len > 32)
+        log_printhex (data + len - 32, 32, "plain(last32):");
+    }
+
+  /* Take care: even with a buflen of zero an encrypt needs to
+   * be called after gcry_cipher_final and before
+   * gcry_cipher_gettag - at least with libgcrypt 1.8 and OCB
+   * mode.  */
+  err = gcry_cipher_encrypt (cfx->cipher_hd, data, len, NULL, 0);
+  if (err)
+    return err;
+  if (finalize && DBG_FILTER)
+    log_printhex (data, len, "ciphr(1):");
+  err = my_iobuf_write (a, data, len);
+  if (err)
+    return err;
+  cfx->chunklen += len;
+  cfx->total += len;
+
+  if (finalize)
+    {
+      if (DBG_FILTER)
+        log_debug ("writing tag: chunklen=%ju total=%ju\n",
+                   (uintmax_t)cfx->chunklen, (uintmax_t)cfx->total);
+      err = write_auth_tag (cfx, a);
+      if (err)
+        return err;
+
+      cfx->chunkindex++;
+      cfx->chunklen = 0;
+    }
+
+  return 0;
+}
+
+
 /* The core of the flush sub-function of cipher_filter_aead.   */
 static gpg_error_t
 do_flush (cipher_filter_context_t *cfx, iobuf_t a, byte *buf, size_t size)
 {
   gpg_error_t err = 0;
-  int finalize = 0;
+  int finalize;
   size_t n;
 
   /* Put the data into a buffer, flush and encrypt as needed.  */
@@ -266,6 +330,29 @@ do_flush (cipher_filter_context_t *cfx, iobuf_t a, byte *buf, size_t size)
     log_debug ("flushing %zu bytes (cur buflen=%zu)\n", size, cfx->buflen);
   do
     {
+      finalize = 0;
+
+      /* If nothing is buffered we encrypt the caller's buffer in
+       * place, as the CFB filter does, and save the copy.  Only whole
+       * blocks may be encrypted unless the chunk is finished.  */
+      if (!cfx->buflen)
+        {
+          n = cfx->chunksize - cfx->chunklen;
+          if (size >= n)
+            finalize = 1;
+          else
+            n = size - (size % 16);
+          if (n)
+            {
+              err = encrypt_and_write (cfx, a, buf, n, finalize);
+              if (err)
+                goto leave;
+              buf  += n;
+              size -= n;
+              continue;
+            }
+        }
+
       if (cfx->buflen + size < cfx->bufsize)
         n = size;
       else
@@ -290,60 +377,10 @@ do_flush (cipher_filter_context_t *cfx, iobuf_t a, byte *buf, size_t size)
 
       if (cfx->buflen == cfx->bufsize || finalize)
         {
-          if (DBG_FILTER)
-            log_debug ("encrypting: size=%zu buflen=%zu %s n=%zu\n",
-                       size, cfx->buflen, finalize?"(finalize)":"", n);
-
-          if (!cfx->chunklen)
-            {
-              if (DBG_FILTER)
-                log_debug ("start encrypting a new chunk\n");
-              err = set_nonce_and_ad (cfx, 0);
-              if (err)
-                goto leave;
-            }
-
-          if (finalize)
-            gcry_cipher_final (cfx->cipher_hd);
-          if (DBG_FILTER)
-            {
-              if (finalize)
-                log_printhex (cfx->buffer, cfx->buflen, "plain(1):");
-              else if (cfx->buflen > 32)
-                log_printhex (cfx->buffer + cfx->buflen - 32, 32,
-                              "plain(last32):");
-            }
-
-          /* Take care: even with a buflen of zero an encrypt needs to
-           * be called after gcry_cipher_final and before
-           * gcry_cipher_gettag - at least with libgcrypt 1.8 and OCB
-           * mode.  */
-          err = gcry_cipher_encrypt (cfx->cipher_hd, cfx->buffer, cfx->buflen,
-                                     NULL, 0);
+          err = encrypt_and_write (cfx, a, cfx->buffer, cfx->buflen, finalize);
           if (err)
             goto leave;
-          if (finalize && DBG_FILTER)
-            log_printhex (cfx->buffer, cfx->buflen, "ciphr(1):");
-          err = my_iobuf_write (a, cfx->buffer, cfx->buflen);
-          if (err)
-            goto leave;
-          cfx->chunklen += cfx->buflen;
-          cfx->total += cfx->buflen;
           cfx->buflen = 0;
-
-          if (finalize)
-            {
-              if (DBG_FILTER)
-                log_debug ("writing tag: chunklen=%ju total=%ju\n",
-                           (uintmax_t)cfx->chunklen, (uintmax_t)cfx->total);
-              err = write_auth_tag (cfx, a);
-              if (err)
-                goto leave;
-
-              cfx->chunkindex++;
-              cfx->chunklen = 0;
-              finalize = 0;
-            }
         }
     }
   while (size);
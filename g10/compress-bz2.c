@@ -55,7 +55,7 @@ init_compress( compress_filter_context_t *zfx, bz_stream *bzs )
   if((rc=BZ2_bzCompressInit(bzs,level,0,0))!=BZ_OK)
     log_fatal("bz2lib problem: %d\n",rc);
 
-  zfx->outbufsize = 8192;
+  zfx->outbufsize = COMPRESS_BUFFER_SIZE;
   zfx->outbuf = xmalloc( zfx->outbufsize );
 }
 
@@ -105,7 +105,7 @@ init_uncompress( compress_filter_context_t *zfx, bz_stream *bzs )
   if((rc=BZ2_bzDecompressInit(bzs,0,opt.bz2_decompress_lowmem))!=BZ_OK)
     log_fatal("bz2lib problem: %d\n",rc);
 
-  zfx->inbufsize = 2048;
+  zfx->inbufsize = COMPRESS_BUFFER_SIZE;
   zfx->inbuf = xmalloc( zfx->inbufsize );
   bzs->avail_in = 0;
 }
@@ -43,8 +43,18 @@
 #include "filter.h"
 #include "main.h"
 #include "options.h"
+#include "../common/status.h"
+#include "../common/i18n.h"
 
 
+/* The compression ratio is checked after each window of this many
+ * input bytes.  If the output of a window is at least
+ * COMPRESS_MIN_GAIN_PCT percent of the input we switch to store
+ * mode and retry compressing after COMPRESS_RETRY_WINDOWS windows.  */
+#define COMPRESS_CHECK_SIZE    (256*1024)
+#define COMPRESS_MIN_GAIN_PCT  98
+#define COMPRESS_RETRY_WINDOWS 64
+
 #ifdef __riscos__
 #define BYTEF_CAST(a) ((Bytef *)(a))
 #else
@@ -79,6 +89,7 @@ init_compress( compress_filter_context_t *zfx, z_stream *zs )
 	level = Z_DEFAULT_COMPRESSION;
     }
 
+    zfx->level = level;
     if( (rc = zfx->algo == 1? deflateInit2( zs, level, Z_DEFLATED,
 					    -13, 8, Z_DEFAULT_STRATEGY)
 			    : deflateInit( zs, level )
@@ -89,7 +100,7 @@ init_compress( compress_filter_context_t *zfx, z_stream *zs )
 						       "unknown error" );
     }
 
-    zfx->outbufsize = 8192;
+    zfx->outbufsize = COMPRESS_BUFFER_SIZE;
     zfx->outbuf = xmalloc( zfx->outbufsize );
 }
 
@@ -130,6 +141,78 @@ do_compress( compress_filter_context_t *zfx, z_stream *zs, int flush, IOBUF a )
     return 0;
 }
 
+/* Switch the deflate level of the stream ZS to LEVEL.  All pending
+ * output is written to A first.  */
+static int
+set_compress_level (compress_filter_context_t *zfx, z_stream *zs,
+                    int level, IOBUF a)
+{
+    int rc;
+    int zrc;
+    unsigned n;
+
+    /* Finish the current block so that deflateParams has nothing
+     * left to flush.  */
+    do {
+	zs->next_out = BYTEF_CAST (zfx->outbuf);
+	zs->avail_out = zfx->outbufsize;
+	zrc = deflate( zs, Z_BLOCK );
+	if( zrc != Z_OK && zrc != Z_BUF_ERROR )
+	    log_fatal("zlib deflate problem: rc=%d\n", zrc );
+	n = zfx->outbufsize - zs->avail_out;
+	if( n && (rc=iobuf_write( a, zfx->outbuf, n )) )
+	    return rc;
+    } while( !zs->avail_out );
+
+    zs->next_out = BYTEF_CAST (zfx->outbuf);
+    zs->avail_out = zfx->outbufsize;
+    zrc = deflateParams( zs, level, Z_DEFAULT_STRATEGY );
+    if( zrc != Z_OK )
+	log_fatal("zlib deflateParams problem: rc=%d\n", zrc );
+    n = zfx->outbufsize - zs->avail_out;
+    if( n && (rc=iobuf_write( a, zfx->outbuf, n )) )
+	return rc;
+    return 0;
+}
+
+/****************
+ * Check the compression ratio of the last window of input and switch
+ * to store mode (level 0) if compressing does not pay off.  While in
+ * store mode we try the requested level again from time to time so
+ * that compressible data later in the stream is still compressed.
+ */
+static int
+check_compress_ratio( compress_filter_context_t *zfx, z_stream *zs, IOBUF a )
+{
+    unsigned long nin, nout;
+    int rc = 0;
+
+    nin = zs->total_in - zfx->win_in;
+    if( nin < COMPRESS_CHECK_SIZE )
+	return 0;
+    nout = zs->total_out - zfx->win_out;
+
+    if( zfx->stored ) {
+	zfx->nstored += nin;
+	if( ++zfx->stored > COMPRESS_RETRY_WINDOWS ) {
+	    if( DBG_FILTER )
+		log_debug("compress: trying level %d again\n", zfx->level );
+	    rc = set_compress_level( zfx, zs, zfx->level, a );
+	    zfx->stored = 0;
+	}
+    }
+    else if( nout >= nin / 100 * COMPRESS_MIN_GAIN_PCT ) {
+	if( opt.verbose )
+	    log_info(_("data is not compressible - storing it\n"));
+	rc = set_compress_level( zfx, zs, 0, a );
+	zfx->stored = 1;
+    }
+
+    zfx->win_in = zs->total_in;
+    zfx->win_out = zs->total_out;
+    return rc;
+}
+
 static void
 init_uncompress( compress_filter_context_t *zfx, z_stream *zs )
 {
@@ -153,7 +236,7 @@ init_uncompress( compress_filter_context_t *zfx, z_stream *zs )
 						       "unknown error" );
     }
 
-    zfx->inbufsize = 2048;
+    zfx->inbufsize = COMPRESS_BUFFER_SIZE;
     zfx->inbuf = xmalloc( zfx->inbufsize );
     zs->avail_in = 0;
 }
@@ -266,6 +349,8 @@ compress_filter( void *opaque, int control,
 	zs->next_in = BYTEF_CAST (buf);
 	zs->avail_in = size;
 	rc = do_compress( zfx, zs, Z_NO_FLUSH, a );
+	if( !rc && zfx->level )
+	    rc = check_compress_ratio( zfx, zs, a );
     }
     else if( control == IOBUFCTRL_FREE ) {
 	if( zfx->status == 1 ) {
@@ -278,6 +363,14 @@ compress_filter( void *opaque, int control,
 	    zs->next_in = BYTEF_CAST (buf);
 	    zs->avail_in = 0;
 	    do_compress( zfx, zs, Z_FINISH, a );
+	    if( zfx->stored )
+		zfx->nstored += zs->total_in - zfx->win_in;
+	    if( zfx->nstored )
+		write_status_printf (STATUS_COMPRESS_STORED, "%d %lu %lu %lu",
+				     zfx->algo,
+				     (unsigned long)zs->total_in,
+				     (unsigned long)zs->total_out,
+				     zfx->nstored);
 	    deflateEnd(zs);
 	    xfree(zs);
 	    zfx->opaque = NULL;
@@ -39,6 +39,11 @@ static int mdc_decode_filter ( void *opaque, int control, IOBUF a,
 static int decode_filter ( void *opaque, int control, IOBUF a,
 					byte *buf, size_t *ret_len);
 
+/* The number of bytes the MDC filter decrypts before hashing them.
+ * This should fit into the first level cache.  */
+#define MDC_SLICE_SIZE (16*1024)
+
+
 /* Our context object.  */
 struct decode_filter_context_s
 {
@@ -605,7 +610,8 @@ aead_underflow (decode_filter_ctx_t dfx, iobuf_t a, byte *buf, size_t *ret_len)
   gpg_error_t err;
   size_t totallen = 0; /* The number of bytes to return on success or EOF.  */
   size_t off = 0;      /* The offset into the buffer.  */
-  size_t len;          /* The current number of bytes in BUF+OFF.  */
+  size_t gap = 0;      /* The number of tag bytes removed before OFF.  */
+  size_t len;          /* The current number of bytes in BUF+OFF+GAP.  */
 
   log_assert (size > 48); /* Our code requires at least this size.  */
 
@@ -677,6 +683,12 @@ aead_underflow (decode_filter_ctx_t dfx, iobuf_t a, byte *buf, size_t *ret_len)
             goto leave;
         }
 
+      /* Close the gap left by the tags removed so far.  Moving only
+       * the data of this chunk keeps the cost linear in the size of
+       * the buffer even for small chunks.  */
+      if (gap)
+        memmove (buf + off, buf + off + gap, n);
+
       /* log_printhex (buf, n, "ciph:"); */
       gcry_cipher_final (dfx->cipher_hd);
       err = gcry_cipher_decrypt (dfx->cipher_hd, buf+off, n, NULL, 0);
@@ -703,7 +715,7 @@ aead_underflow (decode_filter_ctx_t dfx, iobuf_t a, byte *buf, size_t *ret_len)
           /* The tag is not entirely in the buffer.  Read the rest of
            * the tag from the holdback buffer.  Then shift the holdback
            * buffer and fill it up again.  */
-          memcpy (tagbuf, buf+off, len);
+          memcpy (tagbuf, buf+off+gap, len);
           memcpy (tagbuf + len, dfx->holdback, 16 - len);
           dfx->holdbacklen -= 16-len;
           memmove (dfx->holdback, dfx->holdback + (16-len), dfx->holdbacklen);
@@ -734,9 +746,9 @@ aead_underflow (decode_filter_ctx_t dfx, iobuf_t a, byte *buf, size_t *ret_len)
         }
       else /* We already have the full tag.  */
         {
-          memcpy (tagbuf, buf+off, 16);
+          memcpy (tagbuf, buf+off+gap, 16);
           /* Remove that tag from the output.  */
-          memmove (buf + off, buf + off + 16, len - 16);
+          gap += 16;
           len -= 16;
         }
       err = aead_checktag (dfx, 0, tagbuf);
@@ -751,6 +763,9 @@ aead_underflow (decode_filter_ctx_t dfx, iobuf_t a, byte *buf, size_t *ret_len)
   /* The bulk decryption of our buffer.  */
   if (len)
     {
+      if (gap)
+        memmove (buf + off, buf + off + gap, len);
+
       if (!dfx->chunklen)
         {
           /* First data for this chunk - prepare.  */
@@ -944,10 +959,22 @@ mdc_decode_filter (void *opaque, int control, IOBUF a,
 
       if ( n )
         {
-          if ( dfx->cipher_hd )
-            gcry_cipher_decrypt (dfx->cipher_hd, buf, n, NULL, 0);
-          if ( dfx->mdc_hash )
-            gcry_md_write (dfx->mdc_hash, buf, n);
+          size_t off, nslice;
+
+          /* Decrypt and hash in slices so that the plaintext is still
+           * in the cache when it is hashed.  CFB mode allows to
+           * continue decryption at any offset.  */
+          for (off = 0; off < n; off += nslice)
+            {
+              nslice = n - off;
+              if (nslice > MDC_SLICE_SIZE)
+                nslice = MDC_SLICE_SIZE;
+              if ( dfx->cipher_hd )
+                gcry_cipher_decrypt (dfx->cipher_hd, buf + off, nslice,
+                                     NULL, 0);
+              if ( dfx->mdc_hash )
+                gcry_md_write (dfx->mdc_hash, buf + off, nslice);
+            }
 	}
       else
         {
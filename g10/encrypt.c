@@ -1096,8 +1096,11 @@ write_pubkey_enc (ctrl_t ctrl,
    * array has a size which depends on the used algorithm (e.g. 2
    * for Elgamal).  We don't need frame anymore because we have
    * everything now in enc->data which is the passed to
-   * build_packet().  */
+   * build_packet().  ECDH uses its own padding and does not need the
+   * size of the key; we skip the computation of that size because it
+   * is not cheap for ECC keys and this is done for each recipient.  */
   frame = encode_session_key (pk->pubkey_algo, dek,
+                              pk->pubkey_algo == PUBKEY_ALGO_ECDH? 0 :
                               pubkey_nbits (pk->pubkey_algo, pk->pkey));
   rc = pk_encrypt (pk->pubkey_algo, enc->data, frame, pk, pk->pkey);
   gcry_mpi_release (frame);
@@ -1156,10 +1159,15 @@ write_pubkey_enc_from_list (ctrl_t ctrl, PK_LIST pk_list, DEK *dek, iobuf_t out)
   return 0;
 }
 
+/* Encrypt all files given by FILES to the recipients REMUSR.  If
+ * NFILES is 0 the file names are read from stdin.  The recipient list
+ * is resolved only once and then used for all files.  */
 void
 encrypt_crypt_files (ctrl_t ctrl, int nfiles, char **files, strlist_t remusr)
 {
   int rc = 0;
+  gpg_error_t pk_err;
+  pk_list_t pk_list = NULL;
 
   if (opt.outfile)
     {
@@ -1167,6 +1175,11 @@ encrypt_crypt_files (ctrl_t ctrl, int nfiles, char **files, strlist_t remusr)
       return;
     }
 
+  /* Looking up and validating the keys is the most expensive part
+   * when encrypting many small files; thus do this only once.  If
+   * that fails the error is still reported for each file.  */
+  pk_err = build_pk_list (ctrl, remusr, &pk_list);
+
   if (!nfiles)
     {
       char line[2048];
@@ -1177,11 +1190,12 @@ encrypt_crypt_files (ctrl_t ctrl, int nfiles, char **files, strlist_t remusr)
           if (!*line || line[strlen(line)-1] != '\n')
             {
               log_error("input line %u too long or missing LF\n", lno);
-              return;
+              goto leave;
             }
           line[strlen(line)-1] = '\0';
           print_file_status(STATUS_FILE_START, line, 2);
-          rc = encrypt_crypt (ctrl, -1, line, remusr, 0, NULL, -1);
+          rc = pk_err? pk_err
+                     : encrypt_crypt (ctrl, -1, line, remusr, 0, pk_list, -1);
           if (rc)
             log_error ("encryption of '%s' failed: %s\n",
                        print_fname_stdin(line), gpg_strerror (rc) );
@@ -1193,11 +1207,16 @@ encrypt_crypt_files (ctrl_t ctrl, int nfiles, char **files, strlist_t remusr)
       while (nfiles--)
         {
           print_file_status(STATUS_FILE_START, *files, 2);
-          if ( (rc = encrypt_crypt (ctrl, -1, *files, remusr, 0, NULL, -1)) )
+          rc = pk_err? pk_err
+                     : encrypt_crypt (ctrl, -1, *files, remusr, 0, pk_list, -1);
+          if (rc)
             log_error("encryption of '%s' failed: %s\n",
                       print_fname_stdin(*files), gpg_strerror (rc) );
           write_status( STATUS_FILE_DONE );
           files++;
         }
     }
+
+ leave:
+  release_pk_list (pk_list);
 }
@@ -76,7 +76,8 @@ static recsel_expr_t export_drop_subkey;
 
 /* Local prototypes.  */
 static int do_export (ctrl_t ctrl, strlist_t users, int secret,
-                      unsigned int options, export_stats_t stats);
+                      unsigned int options, export_stats_t stats,
+                      int out_fd);
 static int do_export_stream (ctrl_t ctrl, iobuf_t out,
                              strlist_t users, int secret,
                              kbnode_t *keyblock_out, unsigned int options,
@@ -250,7 +251,19 @@ int
 export_pubkeys (ctrl_t ctrl, strlist_t users, unsigned int options,
                 export_stats_t stats)
 {
-  return do_export (ctrl, users, 0, options, stats);
+  return do_export (ctrl, users, 0, options, stats, -1);
+}
+
+
+/*
+ * Export public keys to the file descriptor OUT_FD.  This is the same
+ * as export_pubkeys and used by the server.
+ */
+int
+export_pubkeys_fd (ctrl_t ctrl, strlist_t users, int out_fd,
+                   unsigned int options, export_stats_t stats)
+{
+  return do_export (ctrl, users, 0, options, stats, out_fd);
 }
 
 
@@ -267,7 +280,7 @@ int
 export_seckeys (ctrl_t ctrl, strlist_t users, unsigned int options,
                 export_stats_t stats)
 {
-  return do_export (ctrl, users, 1, options, stats);
+  return do_export (ctrl, users, 1, options, stats, -1);
 }
 
 
@@ -286,7 +299,7 @@ int
 export_secsubkeys (ctrl_t ctrl, strlist_t users, unsigned int options,
                    export_stats_t stats)
 {
-  return do_export (ctrl, users, 2, options, stats);
+  return do_export (ctrl, users, 2, options, stats, -1);
 }
 
 
@@ -350,10 +363,11 @@ export_pubkey_buffer (ctrl_t ctrl, const char *keyspec, unsigned int options,
    Secret is false public keys will be exported.  With secret true
    secret keys will be exported; in this case 1 means the entire
    secret keyblock and 2 only the subkeys.  OPTIONS are the export
-   options to apply.  */
+   options to apply.  If OUT_FD is not -1 the output is written to
+   that file descriptor.  */
 static int
 do_export (ctrl_t ctrl, strlist_t users, int secret, unsigned int options,
-           export_stats_t stats)
+           export_stats_t stats, int out_fd)
 {
   IOBUF out = NULL;
   int any, rc;
@@ -362,7 +376,7 @@ do_export (ctrl_t ctrl, strlist_t users, int secret, unsigned int options,
 
   memset( &zfx, 0, sizeof zfx);
 
-  rc = open_outfile (-1, NULL, 0, !!secret, &out );
+  rc = open_outfile (out_fd, NULL, 0, !!secret, &out );
   if (rc)
     return rc;
 
@@ -1542,6 +1556,31 @@ print_pka_or_dane_records (iobuf_t out, kbnode_t keyblock, PKT_public_key *pk,
 }
 
 
+/* Return true if the signature SIG shall be exported according to
+ * the export OPTIONS.  */
+static int
+export_sig_p (PKT_signature *sig, unsigned int options)
+{
+  int i;
+
+  /* Do not export packets which are marked as not exportable.  */
+  if (!(options & EXPORT_LOCAL_SIGS) && !sig->flags.exportable)
+    return 0;
+
+  /* Do not export packets with a "sensitive" revocation key unless
+   * the user wants us to.  Note that we do export these when issuing
+   * the actual revocation (see revoke.c). */
+  if (!(options & EXPORT_SENSITIVE_REVKEYS) && sig->revkey)
+    {
+      for (i = 0; i < sig->numrevkeys; i++)
+        if ((sig->revkey[i].class & 0x40))
+          return 0;
+    }
+
+  return 1;
+}
+
+
 /* Helper for do_export_stream which writes one keyblock to OUT.  */
 static gpg_error_t
 do_export_one_keyblock (ctrl_t ctrl, kbnode_t keyblock, u32 *keyid,
@@ -1629,29 +1668,9 @@ do_export_one_keyblock (ctrl_t ctrl, kbnode_t keyblock, u32 *keyid,
           }
         }
 
-      if (node->pkt->pkttype == PKT_SIGNATURE)
-        {
-          /* Do not export packets which are marked as not
-           * exportable.  */
-          if (!(options & EXPORT_LOCAL_SIGS)
-              && !node->pkt->pkt.signature->flags.exportable)
-            continue; /* not exportable */
-
-          /* Do not export packets with a "sensitive" revocation key
-           * unless the user wants us to.  Note that we do export
-           * these when issuing the actual revocation (see revoke.c). */
-          if (!(options & EXPORT_SENSITIVE_REVKEYS)
-              && node->pkt->pkt.signature->revkey)
-            {
-              int i;
-
-              for (i = 0; i < node->pkt->pkt.signature->numrevkeys; i++)
-                if ((node->pkt->pkt.signature->revkey[i].class & 0x40))
-                  break;
-              if (i < node->pkt->pkt.signature->numrevkeys)
-                continue;
-            }
-        }
+      if (node->pkt->pkttype == PKT_SIGNATURE
+          && !export_sig_p (node->pkt->pkt.signature, options))
+        continue;
 
       /* Don't export user ids (and attributes)?  This is not RFC-4880
        * compliant but we allow it anyway.  */
@@ -1847,6 +1866,261 @@ do_export_one_keyblock (ctrl_t ctrl, kbnode_t keyblock, u32 *keyid,
 }
 
 
+/* Parse the header of the packet at the begin of the keyblock image
+ * BUF of length BUFLEN.  On success store the packet type at
+ * R_PKTTYPE, the length of the header at R_HDRLEN and the length of
+ * the entire packet at R_NTOTAL.  */
+static gpg_error_t
+image_packet_header (const byte *buf, size_t buflen, int *r_pkttype,
+                     size_t *r_hdrlen, size_t *r_ntotal)
+{
+  size_t n = 0;
+  size_t pktlen;
+  int ctb, c, lenbytes;
+
+  if (!buflen)
+    return gpg_error (GPG_ERR_NO_DATA);
+
+  ctb = buf[n++];
+  if (!(ctb & 0x80))
+    return gpg_error (GPG_ERR_INV_PACKET);
+
+  if ((ctb & 0x40))  /* New style CTB.  */
+    {
+      *r_pkttype = (ctb & 0x3f);
+      if (n >= buflen)
+        return gpg_error (GPG_ERR_INV_PACKET);
+      c = buf[n++];
+      if (c < 192)
+        pktlen = c;
+      else if (c < 224)
+        {
+          if (n >= buflen)
+            return gpg_error (GPG_ERR_INV_PACKET);
+          pktlen = (c - 192) * 256 + buf[n++] + 192;
+        }
+      else if (c == 255)
+        {
+          if (n + 4 > buflen)
+            return gpg_error (GPG_ERR_INV_PACKET);
+          pktlen = buf32_to_size_t (buf + n);
+          n += 4;
+        }
+      else /* Partial lengths are not allowed in a keyblock.  */
+        return gpg_error (GPG_ERR_UNEXPECTED);
+    }
+  else /* Old style CTB.  */
+    {
+      *r_pkttype = ((ctb >> 2) & 0xf);
+      lenbytes = ((ctb & 3) == 3)? 0 : (1 << (ctb & 3));
+      if (!lenbytes || n + lenbytes > buflen)
+        return gpg_error (GPG_ERR_INV_PACKET);
+      for (pktlen = 0; lenbytes; lenbytes--)
+        pktlen = (pktlen << 8) | buf[n++];
+    }
+
+  if (pktlen > buflen - n)
+    return gpg_error (GPG_ERR_INV_PACKET);
+
+  *r_hdrlen = n;
+  *r_ntotal = n + pktlen;
+  return 0;
+}
+
+
+/* Parse the subpacket areas of the signature packet body DATA of
+ * length DATALEN into the fields of SIG which are used by
+ * export_sig_p.  This uses the same functions as parse_signature to
+ * evaluate the subpackets.  The caller must release the fields of SIG
+ * using image_sig_release also on error.  */
+static gpg_error_t
+image_sig_parse (const byte *data, size_t datalen, PKT_signature *sig)
+{
+  subpktarea_t **area;
+  size_t off, n;
+  const byte *p;
+  int i;
+
+  memset (sig, 0, sizeof *sig);
+  sig->flags.exportable = 1;
+
+  if (!datalen)
+    return gpg_error (GPG_ERR_INV_PACKET);
+  if (data[0] == 2 || data[0] == 3)
+    return 0;  /* No subpackets in v3 signatures.  */
+  if ((data[0] != 4 && data[0] != 5) || datalen < 4)
+    return gpg_error (GPG_ERR_INV_PACKET);
+
+  sig->version = data[0];
+  sig->sig_class = data[1];
+  sig->pubkey_algo = data[2];
+  sig->digest_algo = data[3];
+
+  off = 4;
+  for (i = 0; i < 2; i++)
+    {
+      area = i? &sig->unhashed : &sig->hashed;
+      if (off + 2 > datalen)
+        return gpg_error (GPG_ERR_INV_PACKET);
+      n = buf16_to_uint (data + off);
+      off += 2;
+      if (n > datalen - off || n > 10000)
+        return gpg_error (GPG_ERR_INV_PACKET);
+      if (n)
+        {
+          *area = xtrymalloc (sizeof **area + n - 1);
+          if (!*area)
+            return gpg_error_from_syserror ();
+          (*area)->size = n;
+          (*area)->len = n;
+          memcpy ((*area)->data, data + off, n);
+          off += n;
+        }
+    }
+  if (off + 2 > datalen)
+    return gpg_error (GPG_ERR_INV_PACKET);
+
+  if (sig->pubkey_algo)
+    {
+      /* See parse_signature.  */
+      p = parse_sig_subpkt (sig->hashed, SIGSUBPKT_EXPORTABLE, NULL);
+      if (!p)
+        p = parse_sig_subpkt (sig->unhashed, SIGSUBPKT_EXPORTABLE, NULL);
+      if (p && *p == 0)
+        sig->flags.exportable = 0;
+
+      if (sig->sig_class == 0x1F)
+        parse_revkeys (sig);
+    }
+
+  return 0;
+}
+
+
+/* Release the fields of SIG set by image_sig_parse.  */
+static void
+image_sig_release (PKT_signature *sig)
+{
+  xfree (sig->hashed);
+  xfree (sig->unhashed);
+  xfree (sig->revkey);
+}
+
+
+/* Print the EXPORTED status line for the primary key packet at IMAGE
+ * of total length NTOTAL.  */
+static void
+image_print_status_exported (const byte *image, size_t ntotal)
+{
+  struct parse_packet_ctx_s parsectx;
+  PACKET pkt;
+  iobuf_t a;
+
+  if (!is_status_enabled ())
+    return;
+
+  a = iobuf_temp_with_content ((const char *)image, ntotal);
+  init_packet (&pkt);
+  init_parse_packet (&parsectx, a);
+  if (!parse_packet (&parsectx, &pkt) && pkt.pkttype == PKT_PUBLIC_KEY)
+    print_status_exported (pkt.pkt.public_key);
+  free_packet (&pkt, &parsectx);
+  deinit_parse_packet (&parsectx);
+  iobuf_close (a);
+}
+
+
+/* Export the public keyblock IMAGE of length IMAGELEN as taken from
+ * the keybox to OUT without parsing and rebuilding the packets.  Ring
+ * trust packets are stripped and the packet level export OPTIONS are
+ * applied.  This is only used if no filter or cleaning is requested.
+ * GPG_ERR_UNEXPECTED is returned without writing anything if the
+ * image needs to be handled by the regular code.  */
+static gpg_error_t
+export_keyblock_image (const byte *image, size_t imagelen, iobuf_t out,
+                       unsigned int options, export_stats_t stats, int *any)
+{
+  gpg_error_t err;
+  const byte *p;
+  size_t len, hdrlen, ntotal;
+  int pass, pkttype, skip_sigs, exported;
+  PKT_signature sig;
+
+  /* In the first pass we only check that we can handle the image.  */
+  for (pass = 0; pass < 2; pass++)
+    {
+      skip_sigs = 0;
+      for (p = image, len = imagelen; len; p += ntotal, len -= ntotal)
+        {
+          err = image_packet_header (p, len, &pkttype, &hdrlen, &ntotal);
+          if (err)
+            return gpg_error (GPG_ERR_UNEXPECTED);
+
+          if (p == image && pkttype != PKT_PUBLIC_KEY)
+            return gpg_error (GPG_ERR_UNEXPECTED);
+
+          switch (pkttype)
+            {
+            case PKT_PUBLIC_KEY:
+            case PKT_PUBLIC_SUBKEY:
+              if (pkttype == PKT_PUBLIC_KEY && p != image)
+                return gpg_error (GPG_ERR_UNEXPECTED);
+              skip_sigs = 0;
+              break;
+
+            case PKT_USER_ID:
+            case PKT_ATTRIBUTE:
+              skip_sigs = ((options & EXPORT_DROP_UIDS)
+                           || (pkttype == PKT_ATTRIBUTE
+                               && !(options & EXPORT_ATTRIBUTES)));
+              if (skip_sigs)
+                continue;
+              break;
+
+            case PKT_SIGNATURE:
+              if (skip_sigs)
+                continue;
+              err = image_sig_parse (p + hdrlen, ntotal - hdrlen, &sig);
+              exported = !err && export_sig_p (&sig, options);
+              image_sig_release (&sig);
+              if (err)
+                return gpg_error (GPG_ERR_UNEXPECTED);
+              if (!exported)
+                continue;
+              break;
+
+            case PKT_RING_TRUST:
+              continue;
+
+            default:
+              /* The parser would skip unknown packets with a
+               * diagnostic.  */
+              return gpg_error (GPG_ERR_UNEXPECTED);
+            }
+
+          if (!pass)
+            continue;
+
+          err = iobuf_write (out, p, ntotal);
+          if (err)
+            {
+              log_error ("error writing keyblock image: %s\n",
+                         gpg_strerror (err));
+              return err;
+            }
+          if (pkttype == PKT_PUBLIC_KEY)
+            {
+              stats->exported++;
+              image_print_status_exported (p, ntotal);
+            }
+          *any = 1;
+        }
+    }
+
+  return 0;
+}
+
+
 /* Export the keys identified by the list of strings in USERS to the
    stream OUT.  If SECRET is false public keys will be exported.  With
    secret true secret keys will be exported; in this case 1 means the
@@ -1872,6 +2146,7 @@ do_export_stream (ctrl_t ctrl, iobuf_t out, strlist_t users, int secret,
   gcry_cipher_hd_t cipherhd = NULL;
   struct export_stats_s dummystats;
   iobuf_t out_help = NULL;
+  int use_image;
 
   if (!stats)
     stats = &dummystats;
@@ -1958,6 +2233,12 @@ do_export_stream (ctrl_t ctrl, iobuf_t out, strlist_t users, int secret,
       kek = NULL;
     }
 
+  /* When exporting all public keys without any filter or cleaning we
+   * can stream the keyblock images as stored in the keybox.  */
+  use_image = (!users && !secret && !keyblock_out && !out_help
+               && !(options & (EXPORT_CLEAN | EXPORT_BACKUP))
+               && !export_keep_uid && !export_drop_subkey);
+
   for (;;)
     {
       u32 keyid[2];
@@ -1969,6 +2250,35 @@ do_export_stream (ctrl_t ctrl, iobuf_t out, strlist_t users, int secret,
       if (err)
         break;
 
+      if (use_image)
+        {
+          iobuf_t image;
+
+          err = keydb_get_keyblock_image (kdbhd, &image);
+          if (!err)
+            {
+              err = export_keyblock_image (iobuf_get_temp_buffer (image),
+                                           iobuf_get_temp_length (image),
+                                           out, options, stats, any);
+              iobuf_close (image);
+              if (!err)
+                {
+                  stats->count++;
+                  continue;
+                }
+              if (gpg_err_code (err) != GPG_ERR_UNEXPECTED)
+                goto leave;
+            }
+          else if (gpg_err_code (err) != GPG_ERR_NOT_SUPPORTED)
+            {
+              log_error (_("error reading keyblock: %s\n"),
+                         gpg_strerror (err));
+              goto leave;
+            }
+          /* Not a keybox or not a simple image - use the parser.  */
+          err = 0;
+        }
+
       /* Read the keyblock. */
       release_kbnode (keyblock);
       keyblock = NULL;
@@ -71,6 +71,10 @@ typedef struct {
 
 
 
+/* The size of the input and output buffers of the compress filters.
+ * This should match the default iobuf buffer size.  */
+#define COMPRESS_BUFFER_SIZE (64*1024)
+
 struct compress_filter_context_s {
     int status;
     void *opaque;   /* (used for z_stream) */
@@ -82,6 +86,10 @@ struct compress_filter_context_s {
     int algo1hack;
     int new_ctb;
     void (*release)(struct compress_filter_context_s*);
+    int level;          /* The deflate level requested.  */
+    int stored;         /* Number of windows done in store mode.  */
+    unsigned long win_in, win_out; /* Stream totals at window start.  */
+    unsigned long nstored; /* Bytes passed through in store mode.  */
 };
 typedef struct compress_filter_context_s compress_filter_context_t;
 
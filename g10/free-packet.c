@@ -132,6 +132,11 @@ release_public_key_parts (PKT_public_key *pk)
       xfree (pk->updateurl);
       pk->updateurl = NULL;
     }
+  if (pk->import_digest)
+    {
+      xfree (pk->import_digest);
+      pk->import_digest = NULL;
+    }
 }
 
 
@@ -229,6 +234,11 @@ copy_public_key (PKT_public_key *d, PKT_public_key *s)
     d->serialno = xstrdup (s->serialno);
   if (s->updateurl)
     d->updateurl = xstrdup (s->updateurl);
+  if (s->import_digest)
+    {
+      d->import_digest = xmalloc (IMPORT_DIGEST_LEN);
+      memcpy (d->import_digest, s->import_digest, IMPORT_DIGEST_LEN);
+    }
 
   return d;
 }
@@ -395,6 +395,7 @@ enum cmd_and_opt_values
     oNoMangleDosFilenames,
     oEnableProgressFilter,
     oMultifile,
+    oSignedData,
     oKeyidFormat,
     oExitOnStatusWriteError,
     oLimitCardInsertTries,
@@ -599,6 +600,8 @@ static ARGPARSE_OPTS opts[] = {
   ARGPARSE_p_u (oMaxOutput, "max-output", "@"),
   ARGPARSE_s_s (oInputSizeHint, "input-size-hint", "@"),
   ARGPARSE_s_i (oChunkSize, "chunk-size", "@"),
+  ARGPARSE_s_s (oSignedData, "signed-data",
+                N_("|FILE|verify all signatures against FILE")),
 
   ARGPARSE_s_n (oVerbose, "verbose", N_("verbose")),
   ARGPARSE_s_n (oQuiet,	  "quiet",   "@"),
@@ -3540,6 +3543,7 @@ main (int argc, char **argv)
           case oNoMangleDosFilenames: opt.mangle_dos_filenames = 0; break;
           case oEnableProgressFilter: opt.enable_progress_filter = 1; break;
 	  case oMultifile: multifile=1; break;
+	  case oSignedData: opt.signed_data = pargs.r.ret_str; break;
 	  case oKeyidFormat:
 	    if(ascii_strcasecmp(pargs.r.ret_str,"short")==0)
 	      opt.keyid_format=KF_SHORT;
@@ -3958,6 +3962,17 @@ main (int argc, char **argv)
 	  log_error(_("%s does not yet work with %s\n"),cmdname,"--multifile");
       }
 
+    /* The detached signatures are only read by --verify.  */
+    if (opt.signed_data)
+      {
+        if (multifile)
+          log_error (_("%s not allowed with %s!\n"),
+                     "--signed-data", "--multifile");
+        else if (cmd != aVerify)
+          log_error (_("%s may only be used with %s\n"),
+                     "--signed-data", "--verify");
+      }
+
     if( log_get_errorcount(0) )
       {
         write_status_failure ("option-postprocessing",
@@ -4105,16 +4120,23 @@ main (int argc, char **argv)
     /* Add the keyrings, but not for some special commands.  We always
      * need to add the keyrings if we are running under SELinux, this
      * is so that the rings are added to the list of secured files.
-     * We do not add any keyring if --no-keyring has been used.  */
+     * We do not add any keyring if --no-keyring has been used.  The
+     * commands which never look at a key are skipped because
+     * registering a keyring may stat, lock or even create files and
+     * these commands are often run many times by scripts.  */
     if (default_keyring >= 0
         && (ALWAYS_ADD_KEYRINGS
-            || (cmd != aDeArmor && cmd != aEnArmor && cmd != aGPGConfTest)))
+            || (cmd != aDeArmor && cmd != aEnArmor && cmd != aGPGConfTest
+                && cmd != aPrintMD && cmd != aPrintMDs
+                && cmd != aGenRandom && cmd != aPrimegen)))
       {
 	if (!nrings || default_keyring > 0)  /* Add default ring. */
 	    keydb_add_resource ("pubring" EXTSEP_S GPGEXT_GPG,
                                 KEYDB_RESOURCE_FLAG_DEFAULT);
 	for (sl = nrings; sl; sl = sl->next )
           keydb_add_resource (sl->d, sl->flags);
+        if (DBG_CLOCK)
+          log_clock ("keyrings registered");
       }
     FREE_STRLIST(nrings);
 
@@ -4235,6 +4257,9 @@ main (int argc, char **argv)
         break;
       }
 
+    if (DBG_CLOCK)
+      log_clock ("init done");
+
     /* The command dispatcher.  */
     switch( cmd )
       {
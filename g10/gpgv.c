@@ -65,6 +65,7 @@ enum cmd_and_opt_values {
   oHomedir,
   oWeakDigest,
   oEnableSpecialFilenames,
+  oSignedData,
   oDebug,
   aTest
 };
@@ -88,6 +89,8 @@ static ARGPARSE_OPTS opts[] = {
   ARGPARSE_s_s (oWeakDigest, "weak-digest",
                 N_("|ALGO|reject signatures made with ALGO")),
   ARGPARSE_s_n (oEnableSpecialFilenames, "enable-special-filenames", "@"),
+  ARGPARSE_s_s (oSignedData, "signed-data",
+                N_("|FILE|verify all signatures against FILE")),
   ARGPARSE_s_s (oDebug, "debug", "@"),
 
   ARGPARSE_end ()
@@ -246,6 +249,7 @@ main( int argc, char **argv )
         case oEnableSpecialFilenames:
           enable_special_filenames ();
           break;
+        case oSignedData: opt.signed_data = pargs.r.ret_str; break;
         default : pargs.err = ARGPARSE_PRINT_ERROR; break;
 	}
     }
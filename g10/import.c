@@ -1786,6 +1786,224 @@ update_key_origin (kbnode_t keyblock, u32 curtime, int origin, const char *url)
 }
 
 
+/* Return true if an import with OPTIONS may be short circuited by
+ * comparing the import digest.  */
+static int
+use_import_digest (unsigned int options, int from_sk)
+{
+  if (from_sk || opt.dry_run || opt.interactive)
+    return 0;
+  if ((options & (IMPORT_SHOW | IMPORT_DRY_RUN
+                  | IMPORT_EXPORT | IMPORT_RESTORE)))
+    return 0;
+  /* Cleaning depends on the current time (e.g. expired signatures)
+   * which is not covered by the digest.  */
+  if ((options & (IMPORT_CLEAN | IMPORT_MINIMAL)))
+    return 0;
+  if (import_filter.keep_uid || import_filter.drop_sig)
+    return 0;
+  return 1;
+}
+
+
+/* Compute the import digest of KEYBLOCK as received and store it at
+ * DIGEST which must provide IMPORT_DIGEST_LEN bytes.  The import
+ * OPTIONS and all settings which change the result of the signature
+ * checks are hashed as well because they change the outcome of an
+ * import.  A keyblock with a key or signature created in the future
+ * gets no digest because the result of its import will change once
+ * that time has been reached.  */
+static gpg_error_t
+compute_import_digest (kbnode_t keyblock, unsigned int options,
+                       byte *digest)
+{
+  gpg_error_t err;
+  iobuf_t iobuf;
+  kbnode_t node;
+  const struct weakhash *weak;
+  byte tmp[7];
+  u32 curtime = make_timestamp ();
+
+  for (node = keyblock; node; node = node->next)
+    {
+      if ((node->pkt->pkttype == PKT_PUBLIC_KEY
+           || node->pkt->pkttype == PKT_PUBLIC_SUBKEY)
+          && node->pkt->pkt.public_key->timestamp > curtime)
+        return gpg_error (GPG_ERR_TIME_CONFLICT);
+      if (node->pkt->pkttype == PKT_SIGNATURE
+          && node->pkt->pkt.signature->timestamp > curtime)
+        return gpg_error (GPG_ERR_TIME_CONFLICT);
+    }
+
+  iobuf = iobuf_temp ();
+
+  tmp[0] = options >> 24;
+  tmp[1] = options >> 16;
+  tmp[2] = options >>  8;
+  tmp[3] = options;
+  tmp[4] = !!opt.allow_non_selfsigned_uid;
+  tmp[5] = opt.compliance;
+  tmp[6] = ((opt.flags.allow_weak_digest_algos? 1 : 0)
+            | (opt.flags.require_cross_cert? 2 : 0)
+            | (opt.ignore_time_conflict? 4 : 0));
+  iobuf_write (iobuf, tmp, 7);
+  /* The list of weak digest algorithms ends with a zero.  */
+  for (weak = opt.weak_digests; weak; weak = weak->next)
+    iobuf_put (iobuf, weak->algo);
+  iobuf_put (iobuf, 0);
+
+  for (node = keyblock; node; node = node->next)
+    {
+      if (is_deleted_kbnode (node))
+        continue;
+      switch (node->pkt->pkttype)
+        {
+        case PKT_PUBLIC_KEY:
+        case PKT_PUBLIC_SUBKEY:
+        case PKT_SIGNATURE:
+        case PKT_USER_ID:
+        case PKT_ATTRIBUTE:
+          break;
+        default:
+          continue;
+        }
+
+      err = build_packet (iobuf, node->pkt);
+      if (err)
+        {
+          iobuf_close (iobuf);
+          return err;
+        }
+    }
+
+  log_assert (gcry_md_get_algo_dlen (GCRY_MD_SHA256) == IMPORT_DIGEST_LEN);
+  gcry_md_hash_buffer (GCRY_MD_SHA256, digest,
+                       iobuf_get_temp_buffer (iobuf),
+                       iobuf_get_temp_length (iobuf));
+  iobuf_close (iobuf);
+  return 0;
+}
+
+
+/* Return the node of KEYBLOCK with the same primary key, subkey,
+ * user ID or attribute as NODE or NULL if there is none.  */
+static kbnode_t
+find_matching_component (kbnode_t keyblock, kbnode_t node)
+{
+  kbnode_t n;
+
+  for (n = keyblock; n; n = n->next)
+    {
+      if (n->pkt->pkttype != node->pkt->pkttype)
+        continue;
+      switch (n->pkt->pkttype)
+        {
+        case PKT_PUBLIC_KEY:
+        case PKT_PUBLIC_SUBKEY:
+          if (!cmp_public_keys (n->pkt->pkt.public_key,
+                                node->pkt->pkt.public_key))
+            return n;
+          break;
+        case PKT_USER_ID:
+        case PKT_ATTRIBUTE:
+          if (!cmp_user_ids (n->pkt->pkt.user_id, node->pkt->pkt.user_id))
+            return n;
+          break;
+        default:
+          return NULL;
+        }
+    }
+  return NULL;
+}
+
+
+/* Return true if the subpacket areas A and B are identical.  */
+static int
+same_subpkt_area (const subpktarea_t *a, const subpktarea_t *b)
+{
+  if (!a || !b)
+    return !a && !b;
+  return a->len == b->len && !memcmp (a->data, b->data, a->len);
+}
+
+
+/* Return true if the signatures A and B are identical.  Unlike
+ * cmp_signatures this compares all signed data and not only the
+ * signature values; the same values with, for example, another class
+ * would make a forged signature valid.  */
+static int
+same_signature (PKT_signature *a, PKT_signature *b)
+{
+  return (a->version == b->version
+          && a->sig_class == b->sig_class
+          && a->digest_algo == b->digest_algo
+          && a->timestamp == b->timestamp
+          && a->digest_start[0] == b->digest_start[0]
+          && a->digest_start[1] == b->digest_start[1]
+          && same_subpkt_area (a->hashed, b->hashed)
+          && same_subpkt_area (a->unhashed, b->unhashed)
+          && !cmp_signatures (a, b));
+}
+
+
+/* Copy the cached verification status of the self-signatures in our
+ * copy KEYBLOCK_ORIG to the identical self-signatures of KEYBLOCK.  A
+ * signature is only considered identical if it is bound to the same
+ * key, subkey or user ID and all its data matches.  This avoids
+ * verifying the self-signatures of a re-imported key again.  KEYID is
+ * the keyid of the primary key.  */
+static void
+transfer_sig_cache (kbnode_t keyblock, kbnode_t keyblock_orig, u32 *keyid)
+{
+  kbnode_t node, n2;
+  kbnode_t ocomp = NULL;  /* Matching component in KEYBLOCK_ORIG.  */
+  PKT_signature *sig;
+
+  for (node = keyblock; node; node = node->next)
+    {
+      if (node->pkt->pkttype != PKT_SIGNATURE)
+        {
+          ocomp = find_matching_component (keyblock_orig, node);
+          continue;
+        }
+
+      sig = node->pkt->pkt.signature;
+      if (!ocomp || sig->flags.checked
+          || keyid[0] != sig->keyid[0] || keyid[1] != sig->keyid[1])
+        continue;
+
+      for (n2 = ocomp->next;
+           n2 && n2->pkt->pkttype == PKT_SIGNATURE; n2 = n2->next)
+        if (n2->pkt->pkt.signature->flags.checked
+            && same_signature (n2->pkt->pkt.signature, sig))
+          {
+            sig->flags.checked = 1;
+            sig->flags.valid = n2->pkt->pkt.signature->flags.valid;
+            break;
+          }
+    }
+}
+
+
+/* Store DIGEST as the import digest of KEYBLOCK so that it will be
+ * written along with the keyblock.  */
+static gpg_error_t
+set_import_digest (kbnode_t keyblock, const byte *digest)
+{
+  PKT_public_key *pk = keyblock->pkt->pkt.public_key;
+
+  if (!pk->import_digest)
+    {
+      pk->import_digest = xtrymalloc (IMPORT_DIGEST_LEN);
+      if (!pk->import_digest)
+        return gpg_error_from_syserror ();
+    }
+  memcpy (pk->import_digest, digest, IMPORT_DIGEST_LEN);
+  pk->flags.import_digest_set = 1;
+  return 0;
+}
+
+
 /*
  * Try to import one keyblock. Return an error only in serious cases,
  * but never for an invalid keyblock.  It uses log_error to increase
@@ -1803,7 +2021,8 @@ import_one_real (ctrl_t ctrl,
                  unsigned char **fpr, size_t *fpr_len, unsigned int options,
                  int from_sk, int silent,
                  import_screener_t screener, void *screener_arg,
-                 int origin, const char *url, int *r_valid)
+                 int origin, const char *url, int *r_valid,
+                 const byte *import_digest)
 {
   gpg_error_t err = 0;
   PKT_public_key *pk;
@@ -1821,6 +2040,7 @@ import_one_real (ctrl_t ctrl,
   int merge_keys_done = 0;
   int any_filter = 0;
   KEYDB_HANDLE hd = NULL;
+  gpg_error_t orig_err = 0;
 
   if (r_valid)
     *r_valid = 0;
@@ -1886,6 +2106,49 @@ import_one_real (ctrl_t ctrl,
         return 0;
     }
 
+  /* If the keyblock is identical to the one we imported the last
+   * time there is no need to check and merge it again.  Our copy and
+   * the locked handle are kept for the insert or merge below.  */
+  if (import_digest)
+    {
+      PKT_public_key *pk_orig;
+
+      orig_err = get_keyblock_byfprint_fast (&keyblock_orig, &hd,
+                                             fpr2, fpr2len, 1/*locked*/);
+      pk_orig = orig_err? NULL : keyblock_orig->pkt->pkt.public_key;
+      if (pk_orig && pk_orig->import_digest
+          && !memcmp (pk_orig->import_digest, import_digest,
+                      IMPORT_DIGEST_LEN)
+          && !cmp_public_keys (pk_orig, pk))
+        {
+          if (opt.verbose > 1)
+            log_info ("key %s: same as last import - not merged\n",
+                      keystr (keyid));
+          if (r_valid)
+            *r_valid = 1;
+          same_key = 1;
+          keydb_release (hd);
+          hd = NULL;
+          if (is_status_enabled ())
+            print_import_ok (pk, 0);
+
+          if (!opt.quiet && !silent)
+            {
+              char *p = get_user_id_byfpr_native (ctrl, fpr2, fpr2len);
+              log_info( _("key %s: \"%s\" not changed\n"),keystr(keyid),p);
+              xfree(p);
+            }
+
+          stats->unchanged++;
+          err = 0;
+          goto leave;
+        }
+      /* The key changed but we can still save the verification of
+       * the self-signatures we already know.  */
+      if (pk_orig && !opt.no_sig_cache)
+        transfer_sig_cache (keyblock, keyblock_orig, keyid);
+    }
+
   /* Remove all non-self-sigs if requested.  Noe that this is a NOP if
    * that option has been globally set but we may also be called
    * latter with the already parsed keyblock and a locally changed
@@ -1924,7 +2187,7 @@ import_one_real (ctrl_t ctrl,
     key_check_all_keysigs (ctrl, 1, keyblock, 0, 0);
 
   if (chk_self_sigs (ctrl, keyblock, keyid, &non_self))
-    return 0;  /* Invalid keyblock - error already printed.  */
+    goto leave;  /* Invalid keyblock - error already printed.  */
 
   /* If we allow such a thing, mark unsigned uids as valid */
   if (opt.allow_non_selfsigned_uid)
@@ -1956,7 +2219,7 @@ import_one_real (ctrl_t ctrl,
             log_info(_("this may be caused by a missing self-signature\n"));
         }
       stats->no_user_id++;
-      return 0;
+      goto leave;
     }
 
   /* Get rid of deleted nodes.  */
@@ -1984,7 +2247,7 @@ import_one_real (ctrl_t ctrl,
       if (!opt.quiet )
         log_info ( _("key %s: no valid user IDs\n"), keystr_from_pk (pk));
       stats->no_user_id++;
-      return 0;
+      goto leave;
     }
 
   /* The keyblock is valid and ready for real import.  */
@@ -2021,9 +2284,12 @@ import_one_real (ctrl_t ctrl,
   if (opt.dry_run || (options & IMPORT_DRY_RUN))
     goto leave;
 
-  /* Do we have this key already in one of our pubrings ? */
-  err = get_keyblock_byfprint_fast (&keyblock_orig, &hd,
-                                    fpr2, fpr2len, 1/*locked*/);
+  /* Do we have this key already in one of our pubrings ?  */
+  if (hd)
+    err = orig_err;  /* Already looked up for the import digest.  */
+  else
+    err = get_keyblock_byfprint_fast (&keyblock_orig, &hd,
+                                      fpr2, fpr2len, 1/*locked*/);
   if ((err
        && gpg_err_code (err) != GPG_ERR_NO_PUBKEY
        && gpg_err_code (err) != GPG_ERR_UNUSABLE_PUBKEY)
@@ -2080,6 +2346,13 @@ import_one_real (ctrl_t ctrl,
             }
         }
 
+      if (import_digest)
+        {
+          err = set_import_digest (keyblock, import_digest);
+          if (err)
+            goto leave;
+        }
+
       err = keydb_insert_keyblock (hd, keyblock );
       if (err)
         log_error (_("error writing keyring '%s': %s\n"),
@@ -2177,6 +2450,13 @@ import_one_real (ctrl_t ctrl,
                 }
             }
 
+          if (import_digest)
+            {
+              err = set_import_digest (keyblock_orig, import_digest);
+              if (err)
+                goto leave;
+            }
+
           mod_key = 1;
           /* KEYBLOCK_ORIG has been updated; write */
           err = keydb_update_keyblock (ctrl, hd, keyblock_orig);
@@ -2243,6 +2523,23 @@ import_one_real (ctrl_t ctrl,
 	}
       else
         {
+          /* Nothing changed but record the import digest so that the
+           * next import of the same keyblock can be short circuited.
+           * This is done only if the key has no digest yet; otherwise
+           * two sources with different but equivalent keyblocks would
+           * make each import rewrite the key.  Failing to do so is not
+           * an error.  */
+          if (import_digest
+              && !keyblock_orig->pkt->pkt.public_key->import_digest
+              && !set_import_digest (keyblock_orig, import_digest))
+            {
+              err = keydb_update_keyblock (ctrl, hd, keyblock_orig);
+              if (err && opt.verbose)
+                log_info ("key %s: error storing import digest: %s\n",
+                          keystr (keyid), gpg_strerror (err));
+              err = 0;
+            }
+
           /* Release the handle and thus unlock the keyring asap.  */
           keydb_release (hd);
           hd = NULL;
@@ -2336,10 +2633,19 @@ import_one (ctrl_t ctrl,
             int origin, const char *url, int *r_valid)
 {
   gpg_error_t err;
+  byte digestbuf[IMPORT_DIGEST_LEN];
+  const byte *import_digest = NULL;
+
+  /* The digest is computed from the keyblock as received and with
+   * the original options; thus we need to do this before the first
+   * attempt.  */
+  if (use_import_digest (options, from_sk)
+      && !compute_import_digest (keyblock, options, digestbuf))
+    import_digest = digestbuf;
 
   err = import_one_real (ctrl, keyblock, stats, fpr, fpr_len, options,
                          from_sk, silent, screener, screener_arg,
-                         origin, url, r_valid);
+                         origin, url, r_valid, import_digest);
   if (gpg_err_code (err) == GPG_ERR_TOO_LARGE
       && gpg_err_source (err) == GPG_ERR_SOURCE_KEYBOX
       && ((options & (IMPORT_SELF_SIGS_ONLY | IMPORT_CLEAN))
@@ -2353,9 +2659,10 @@ import_one (ctrl_t ctrl,
       log_info ("key %s: keyblock too large, retrying with self-sigs-only\n",
                 keystr (keyid));
       options |= IMPORT_SELF_SIGS_ONLY | IMPORT_CLEAN;
+      /* The digest does not describe a cleaned import.  */
       err = import_one_real (ctrl, keyblock, stats, fpr, fpr_len, options,
                              from_sk, silent, screener, screener_arg,
-                             origin, url, r_valid);
+                             origin, url, r_valid, NULL);
     }
   return err;
 }
@@ -31,40 +31,79 @@
 
 #define USE_UNUSED_NODES 1
 
+/* Nodes are allocated in chunks of this many nodes to avoid a malloc
+ * call for each packet of a large keyblock.  Nodes never leave this
+ * module and thus they are only returned to the system at cleanup
+ * time.  */
+#define NODES_PER_CHUNK 128
+
+struct node_chunk_s
+{
+  struct node_chunk_s *next;
+  struct kbnode_struct nodes[NODES_PER_CHUNK];
+};
+
 static int cleanup_registered;
 static KBNODE unused_nodes;
+static struct node_chunk_s *node_chunks;
 
 static void
 release_unused_nodes (void)
 {
 #if USE_UNUSED_NODES
-  while (unused_nodes)
+  struct node_chunk_s *next;
+
+  /* Nodes still in use are not released; that would only happen
+   * with a memory leak anyway.  */
+  unused_nodes = NULL;
+  while (node_chunks)
     {
-      kbnode_t next = unused_nodes->next;
-      xfree (unused_nodes);
-      unused_nodes = next;
+      next = node_chunks->next;
+      xfree (node_chunks);
+      node_chunks = next;
     }
 #endif /*USE_UNUSED_NODES*/
 }
 
 
+#if USE_UNUSED_NODES
+/* Allocate a new chunk of nodes and put them on the free list.  */
+static void
+add_node_chunk (void)
+{
+  struct node_chunk_s *chunk;
+  int i;
+
+  if (!cleanup_registered)
+    {
+      cleanup_registered = 1;
+      register_mem_cleanup_func (release_unused_nodes);
+    }
+  chunk = xmalloc (sizeof *chunk);
+  chunk->next = node_chunks;
+  node_chunks = chunk;
+  for (i = NODES_PER_CHUNK - 1; i >= 0; i--)
+    {
+      chunk->nodes[i].next = unused_nodes;
+      unused_nodes = chunk->nodes + i;
+    }
+}
+#endif /*USE_UNUSED_NODES*/
+
+
 static kbnode_t
 alloc_node (void)
 {
   kbnode_t n;
 
+#if USE_UNUSED_NODES
+  if (!unused_nodes)
+    add_node_chunk ();
   n = unused_nodes;
-  if (n)
-    unused_nodes = n->next;
-  else
-    {
-      if (!cleanup_registered)
-        {
-          cleanup_registered = 1;
-          register_mem_cleanup_func (release_unused_nodes);
-        }
-      n = xmalloc (sizeof *n);
-    }
+  unused_nodes = n->next;
+#else
+  n = xmalloc (sizeof *n);
+#endif
   n->next = NULL;
   n->pkt = NULL;
   n->flag = 0;
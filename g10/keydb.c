@@ -1441,6 +1441,74 @@ keydb_get_keyblock (KEYDB_HANDLE hd, KBNODE *ret_kb)
 }
 
 
+/* Return the raw OpenPGP keyblock image of the keyblock last found by
+ * keydb_search() as a temporary iobuf at R_IMAGE.  The image may
+ * contain ring trust packets.  This is only supported for keybox
+ * resources; for other resources GPG_ERR_NOT_SUPPORTED is returned
+ * and the caller should use keydb_get_keyblock instead.  On success
+ * the caller must close the iobuf.  */
+gpg_error_t
+keydb_get_keyblock_image (KEYDB_HANDLE hd, iobuf_t *r_image)
+{
+  gpg_error_t err;
+  int pk_no, uid_no;
+
+  *r_image = NULL;
+
+  if (!hd)
+    return gpg_error (GPG_ERR_INV_ARG);
+
+  if (hd->keyblock_cache.state == KEYBLOCK_CACHE_FILLED)
+    {
+      *r_image = iobuf_temp_with_content
+        (iobuf_get_temp_buffer (hd->keyblock_cache.iobuf),
+         iobuf_get_temp_length (hd->keyblock_cache.iobuf));
+      return 0;
+    }
+
+  if (hd->found < 0 || hd->found >= hd->used)
+    return gpg_error (GPG_ERR_VALUE_NOT_FOUND);
+
+  switch (hd->active[hd->found].type)
+    {
+    case KEYDB_RESOURCE_TYPE_KEYBOX:
+      err = keybox_get_keyblock (hd->active[hd->found].u.kb,
+                                 r_image, &pk_no, &uid_no);
+      break;
+    case KEYDB_RESOURCE_TYPE_KEYRING:
+      err = gpg_error (GPG_ERR_NOT_SUPPORTED);
+      break;
+    default:
+      err = gpg_error (GPG_ERR_GENERAL); /* oops */
+      break;
+    }
+
+  if (!err)
+    keydb_stats.get_keyblocks++;
+  return err;
+}
+
+
+/* The import digest stored with a keyblock describes the keyblock as
+ * written by the import code.  Any other update (e.g. by keyedit)
+ * invalidates it so that the next import runs the full merge.  */
+static void
+drop_stale_import_digest (kbnode_t keyblock)
+{
+  PKT_public_key *pk;
+
+  if (keyblock->pkt->pkttype != PKT_PUBLIC_KEY)
+    return;
+  pk = keyblock->pkt->pkt.public_key;
+  if (pk->import_digest && !pk->flags.import_digest_set)
+    {
+      xfree (pk->import_digest);
+      pk->import_digest = NULL;
+    }
+  pk->flags.import_digest_set = 0;
+}
+
+
 /* Build a keyblock image from KEYBLOCK.  Returns 0 on success and
  * only then stores a new iobuf object at R_IOBUF.  */
 static gpg_error_t
@@ -1515,6 +1583,7 @@ keydb_update_keyblock (ctrl_t ctrl, KEYDB_HANDLE hd, kbnode_t kb)
 
   kid_not_found_flush ();
   keyblock_cache_clear (hd);
+  drop_stale_import_digest (kb);
 
   if (opt.dry_run)
     return 0;
@@ -1595,6 +1664,7 @@ keydb_insert_keyblock (KEYDB_HANDLE hd, kbnode_t kb)
 
   kid_not_found_flush ();
   keyblock_cache_clear (hd);
+  drop_stale_import_digest (kb);
 
   if (opt.dry_run)
     return 0;
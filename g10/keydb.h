@@ -209,6 +209,9 @@ const char *keydb_get_resource_name (KEYDB_HANDLE hd);
 /* Return the keyblock last found by keydb_search.  */
 gpg_error_t keydb_get_keyblock (KEYDB_HANDLE hd, KBNODE *ret_kb);
 
+/* Return the raw image of the keyblock last found by keydb_search.  */
+gpg_error_t keydb_get_keyblock_image (KEYDB_HANDLE hd, iobuf_t *r_image);
+
 /* Update the keyblock KB.  */
 gpg_error_t keydb_update_keyblock (ctrl_t ctrl, KEYDB_HANDLE hd, kbnode_t kb);
 
@@ -261,6 +261,8 @@ int write_pubkey_enc (ctrl_t ctrl, PKT_public_key *pk, int throw_keyid,
 /*-- sign.c --*/
 int sign_file (ctrl_t ctrl, strlist_t filenames, int detached, strlist_t locusr,
 	       int do_encrypt, strlist_t remusr, const char *outfile );
+int sign_file_fd (ctrl_t ctrl, int inp_fd, int out_fd, int detached,
+                  strlist_t locusr);
 int clearsign_file (ctrl_t ctrl,
                     const char *fname, strlist_t locusr, const char *outfile);
 int sign_symencrypt_file (ctrl_t ctrl, const char *fname, strlist_t locusr);
@@ -418,6 +420,8 @@ int exact_subkey_match_p (KEYDB_SEARCH_DESC *desc, kbnode_t node);
 
 int export_pubkeys (ctrl_t ctrl, strlist_t users, unsigned int options,
                     export_stats_t stats);
+int export_pubkeys_fd (ctrl_t ctrl, strlist_t users, int out_fd,
+                       unsigned int options, export_stats_t stats);
 int export_seckeys (ctrl_t ctrl, strlist_t users, unsigned int options,
                     export_stats_t stats);
 int export_secsubkeys (ctrl_t ctrl, strlist_t users, unsigned int options,
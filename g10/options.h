@@ -55,6 +55,10 @@ struct
   int armor;
   char *outfile;
   estream_t outfp;  /* Hack, sometimes used in place of outfile.  */
+
+  /* If not NULL --verify takes all arguments as detached signatures
+   * for this file.  */
+  const char *signed_data;
   off_t max_output;
 
   /* If > 0 a hint with the expected number of input data bytes.  This
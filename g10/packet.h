@@ -428,6 +428,8 @@ typedef struct
     unsigned int backsig:2;       /* 0=none, 1=bad, 2=good.  */
     unsigned int serialno_valid:1;/* SERIALNO below is valid.  */
     unsigned int exact:1;         /* Found via exact (!) search.  */
+    unsigned int import_digest_set:1; /* IMPORT_DIGEST has been set
+                                         by the import code.  */
   } flags;
   PKT_user_id *user_id;   /* If != NULL: found by that uid. */
   struct revocation_key *revkey;
@@ -438,6 +440,10 @@ typedef struct
   byte    keyorg;         /* From the ring trust packet.  */
   u32     keyupdate;      /* From the ring trust packet.  */
   char    *updateurl;     /* NULL or the URL of the last update origin.  */
+  byte    *import_digest; /* NULL or the malloced SHA-256 digest
+                             (IMPORT_DIGEST_LEN bytes) of the keyblock
+                             as received by the last import.  From
+                             the ring trust packet.  */
   const byte *trust_regexp;
   char    *serialno;      /* Malloced hex string or NULL if it is
                              likely not on a card.  See also
@@ -526,6 +532,9 @@ typedef struct {
 #define RING_TRUST_KEY 1  /* A KEYORG on a primary key.      */
 #define RING_TRUST_UID 2  /* A KEYORG on a user id.          */
 
+/* Length of the import digest stored in a RING_TRUST_KEY packet.  */
+#define IMPORT_DIGEST_LEN 32
+
 /* The local only ring trust packet which OpenPGP declares as
  * implementation defined.  GnuPG uses this to cache signature
  * verification status and since 2.1.18 also to convey information
@@ -539,6 +548,7 @@ typedef struct {
   unsigned char keyorg;  /* The origin of the key (KEYORG_*).        */
   u32 keyupdate;         /* The wall time the key was last updated.  */
   char *url;             /* NULL or the URL of the source.           */
+  byte *import_digest;   /* NULL or the digest of the last import.   */
 } PKT_ring_trust;
 
 
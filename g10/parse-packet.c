@@ -1886,6 +1886,124 @@ parse_sig_subpkt2 (PKT_signature * sig, sigsubpkttype_t reqtype)
 }
 
 
+/* Number of subpacket types tracked by the index used by
+ * parse_signature.  All types we need to look at are below that.  */
+#define SUBPKT_INDEX_SIZE 64
+
+/* The position and length of the first subpacket of each type in a
+ * subpacket area.  */
+struct subpkt_index_s
+{
+  const byte *pos[SUBPKT_INDEX_SIZE];  /* Points to the type octet.  */
+  size_t len[SUBPKT_INDEX_SIZE];       /* Length including the type.  */
+  int malformed;  /* The walk ended at a malformed subpacket: 1 for a
+                   * too short buffer, 2 for a missing type octet.  */
+};
+
+
+/* Walk the subpacket area PKTBUF once and record the first subpacket
+ * of each type in IDX.  The walk follows enum_sig_subpkt exactly: A
+ * subpacket of length zero is recorded with a length of zero under
+ * the type taken from the next octet and the walk continues at that
+ * octet; enum_sig_subpkt fails only when looking for that type.  The
+ * walk stops at the first subpacket which exceeds the area.  */
+static void
+index_sig_subpkts (const subpktarea_t *pktbuf, struct subpkt_index_s *idx)
+{
+  const byte *buffer;
+  size_t buflen, n;
+  int type;
+
+  memset (idx->pos, 0, sizeof idx->pos);
+  idx->malformed = 0;
+  if (!pktbuf)
+    return;
+
+  buffer = pktbuf->data;
+  buflen = pktbuf->len;
+  while (buflen)
+    {
+      n = *buffer++;
+      buflen--;
+      if (n == 255)
+	{
+	  if (buflen < 4)
+	    goto too_short;
+	  n = buf32_to_size_t (buffer);
+	  buffer += 4;
+	  buflen -= 4;
+	}
+      else if (n >= 192)
+	{
+	  if (buflen < 2)
+	    goto too_short;
+	  n = ((n - 192) << 8) + *buffer + 192;
+	  buffer++;
+	  buflen--;
+	}
+      if (buflen < n)
+	goto too_short;
+      if (!buflen)
+        {
+          idx->malformed = 2;
+          return;
+        }
+      type = (*buffer & 0x7f);
+      if (type < SUBPKT_INDEX_SIZE && !idx->pos[type])
+        {
+          idx->pos[type] = buffer;
+          idx->len[type] = n;
+        }
+      buffer += n;
+      buflen -= n;
+    }
+  return;
+
+ too_short:
+  idx->malformed = 1;
+}
+
+
+/* Return the first subpacket of type REQTYPE from the index IDX.
+ * This is the same as parse_sig_subpkt on the indexed area.  */
+static const byte *
+indexed_sig_subpkt (const struct subpkt_index_s *idx,
+                    sigsubpkttype_t reqtype, size_t *ret_n)
+{
+  const byte *buffer;
+  size_t n;
+  int offset;
+
+  log_assert (reqtype >= 0 && reqtype < SUBPKT_INDEX_SIZE);
+  buffer = idx->pos[reqtype];
+  if (!buffer || !idx->len[reqtype])
+    {
+      if (opt.verbose && (idx->malformed == 1
+                          || (buffer && !idx->len[reqtype])))
+        log_info ("buffer shorter than subpacket\n");
+      else if (opt.verbose && idx->malformed == 2)
+        log_info ("type octet missing in subpacket\n");
+      return NULL;
+    }
+  buffer++;
+  n = idx->len[reqtype] - 1;
+  if (ret_n)
+    *ret_n = n;
+  offset = parse_one_sig_subpkt (buffer, n, reqtype);
+  switch (offset)
+    {
+    case -2:
+      log_error ("subpacket of type %d too short\n", reqtype);
+      return NULL;
+    case -1:
+      return NULL;
+    default:
+      break;
+    }
+  return buffer + offset;
+}
+
+
 /* Find all revocation keys.  Look in hashed area only.  */
 void
 parse_revkeys (PKT_signature * sig)
@@ -2057,6 +2175,7 @@ parse_signature (IOBUF inp, int pkttype, unsigned long pktlen,
 
   if (is_v4or5 && sig->pubkey_algo)  /* Extract required information.  */
     {
+      struct subpkt_index_s hidx, uidx;
       const byte *p;
       size_t len;
 
@@ -2066,7 +2185,11 @@ parse_signature (IOBUF inp, int pkttype, unsigned long pktlen,
 	  || !parse_sig_subpkt (sig->unhashed, SIGSUBPKT_TEST_CRITICAL, NULL))
 	sig->flags.unknown_critical = 1;
 
-      p = parse_sig_subpkt (sig->hashed, SIGSUBPKT_SIG_CREATED, NULL);
+      /* Walk the areas only once for all the lookups below.  */
+      index_sig_subpkts (sig->hashed, &hidx);
+      index_sig_subpkts (sig->unhashed, &uidx);
+
+      p = indexed_sig_subpkt (&hidx, SIGSUBPKT_SIG_CREATED, NULL);
       if (p)
 	sig->timestamp = buf32_to_u32 (p);
       else if (!(sig->pubkey_algo >= 100 && sig->pubkey_algo <= 110)
@@ -2076,7 +2199,7 @@ parse_signature (IOBUF inp, int pkttype, unsigned long pktlen,
       /* Set the key id.  We first try the issuer fingerprint and if
        * it is a v4 signature the fallback to the issuer.  Note that
        * only the issuer packet is also searched in the unhashed area.  */
-      p = parse_sig_subpkt (sig->hashed, SIGSUBPKT_ISSUER_FPR, &len);
+      p = indexed_sig_subpkt (&hidx, SIGSUBPKT_ISSUER_FPR, &len);
       if (p && len == 21 && p[0] == 4)
         {
           sig->keyid[0] = buf32_to_u32 (p + 1 + 12);
@@ -2087,7 +2210,8 @@ parse_signature (IOBUF inp, int pkttype, unsigned long pktlen,
           sig->keyid[0] = buf32_to_u32 (p + 1 );
 	  sig->keyid[1] = buf32_to_u32 (p + 1 + 4);
 	}
-      else if ((p = parse_sig_subpkt2 (sig, SIGSUBPKT_ISSUER)))
+      else if ((p = indexed_sig_subpkt (&hidx, SIGSUBPKT_ISSUER, NULL))
+               || (p = indexed_sig_subpkt (&uidx, SIGSUBPKT_ISSUER, NULL)))
         {
           sig->keyid[0] = buf32_to_u32 (p);
 	  sig->keyid[1] = buf32_to_u32 (p + 4);
@@ -2096,21 +2220,21 @@ parse_signature (IOBUF inp, int pkttype, unsigned long pktlen,
 	       && opt.verbose)
 	log_info ("signature packet without keyid\n");
 
-      p = parse_sig_subpkt (sig->hashed, SIGSUBPKT_SIG_EXPIRE, NULL);
+      p = indexed_sig_subpkt (&hidx, SIGSUBPKT_SIG_EXPIRE, NULL);
       if (p && buf32_to_u32 (p))
 	sig->expiredate = sig->timestamp + buf32_to_u32 (p);
       if (sig->expiredate && sig->expiredate <= make_timestamp ())
 	sig->flags.expired = 1;
 
-      p = parse_sig_subpkt (sig->hashed, SIGSUBPKT_POLICY, NULL);
+      p = indexed_sig_subpkt (&hidx, SIGSUBPKT_POLICY, NULL);
       if (p)
 	sig->flags.policy_url = 1;
 
-      p = parse_sig_subpkt (sig->hashed, SIGSUBPKT_PREF_KS, NULL);
+      p = indexed_sig_subpkt (&hidx, SIGSUBPKT_PREF_KS, NULL);
       if (p)
 	sig->flags.pref_ks = 1;
 
-      p = parse_sig_subpkt (sig->hashed, SIGSUBPKT_SIGNERS_UID, &len);
+      p = indexed_sig_subpkt (&hidx, SIGSUBPKT_SIGNERS_UID, &len);
       if (p && len)
         {
           char *mbox;
@@ -2129,15 +2253,15 @@ parse_signature (IOBUF inp, int pkttype, unsigned long pktlen,
             }
         }
 
-      p = parse_sig_subpkt (sig->hashed, SIGSUBPKT_NOTATION, NULL);
+      p = indexed_sig_subpkt (&hidx, SIGSUBPKT_NOTATION, NULL);
       if (p)
 	sig->flags.notation = 1;
 
-      p = parse_sig_subpkt (sig->hashed, SIGSUBPKT_REVOCABLE, NULL);
+      p = indexed_sig_subpkt (&hidx, SIGSUBPKT_REVOCABLE, NULL);
       if (p && *p == 0)
 	sig->flags.revocable = 0;
 
-      p = parse_sig_subpkt (sig->hashed, SIGSUBPKT_TRUST, &len);
+      p = indexed_sig_subpkt (&hidx, SIGSUBPKT_TRUST, &len);
       if (p && len == 2)
 	{
 	  sig->trust_depth = p[0];
@@ -2146,7 +2270,7 @@ parse_signature (IOBUF inp, int pkttype, unsigned long pktlen,
 	  /* Only look for a regexp if there is also a trust
 	     subpacket. */
 	  sig->trust_regexp =
-	    parse_sig_subpkt (sig->hashed, SIGSUBPKT_REGEXP, &len);
+	    indexed_sig_subpkt (&hidx, SIGSUBPKT_REGEXP, &len);
 
 	  /* If the regular expression is of 0 length, there is no
 	     regular expression. */
@@ -2159,7 +2283,9 @@ parse_signature (IOBUF inp, int pkttype, unsigned long pktlen,
          unhashed area.  In theory, anyway, we should never see this
          packet off of a local keyring. */
 
-      p = parse_sig_subpkt2 (sig, SIGSUBPKT_EXPORTABLE);
+      p = indexed_sig_subpkt (&hidx, SIGSUBPKT_EXPORTABLE, NULL);
+      if (!p)
+        p = indexed_sig_subpkt (&uidx, SIGSUBPKT_EXPORTABLE, NULL);
       if (p && *p == 0)
 	sig->flags.exportable = 0;
 
@@ -3054,7 +3180,7 @@ parse_ring_trust (parse_packet_ctx_t ctx, unsigned long pktlen)
   gpg_error_t err;
   iobuf_t inp = ctx->inp;
   PKT_ring_trust rt = {0};
-  int c;
+  int c, i;
   int not_gpg = 0;
 
   if (!pktlen)
@@ -3101,7 +3227,6 @@ parse_ring_trust (parse_packet_ctx_t ctx, unsigned long pktlen)
   if ((rt.subtype == RING_TRUST_KEY || rt.subtype == RING_TRUST_UID)
       && pktlen >= 6 )
     {
-      int i;
       unsigned int namelen;
 
       rt.keyorg = iobuf_get_noeof (inp);
@@ -3122,6 +3247,23 @@ parse_ring_trust (parse_packet_ctx_t ctx, unsigned long pktlen)
             rt.url[i] = iobuf_get_noeof (inp);
           rt.url[i] = 0;
         }
+      /* A key subtype may be followed by the import digest.  */
+      if (rt.subtype == RING_TRUST_KEY && pktlen >= 1 + IMPORT_DIGEST_LEN)
+        {
+          c = iobuf_get_noeof (inp);
+          pktlen--;
+          if (c == IMPORT_DIGEST_LEN)
+            {
+              rt.import_digest = xtrymalloc (IMPORT_DIGEST_LEN);
+              if (!rt.import_digest)
+                {
+                  err = gpg_error_from_syserror ();
+                  goto leave;
+                }
+              for (i = 0; i < IMPORT_DIGEST_LEN; pktlen--, i++)
+                rt.import_digest[i] = iobuf_get_noeof (inp);
+            }
+        }
     }
 
   if (list_mode)
@@ -3148,6 +3290,12 @@ parse_ring_trust (parse_packet_ctx_t ctx, unsigned long pktlen)
                     es_fprintf (listfp, "\\x%02x", *p);
                 }
             }
+          if (rt.import_digest)
+            {
+              es_fputs (" imp=", listfp);
+              for (i = 0; i < IMPORT_DIGEST_LEN; i++)
+                es_fprintf (listfp, "%02x", rt.import_digest[i]);
+            }
           es_putc ('\n', listfp);
         }
       else if (not_gpg)
@@ -3193,12 +3341,16 @@ parse_ring_trust (parse_packet_ctx_t ctx, unsigned long pktlen)
       pk->keyupdate = rt.keyupdate;
       pk->updateurl = rt.url;
       rt.url = NULL;
+      xfree (pk->import_digest);
+      pk->import_digest = rt.import_digest;
+      rt.import_digest = NULL;
     }
 
   err = 0;
 
  leave:
   xfree (rt.url);
+  xfree (rt.import_digest);
   free_packet (NULL, ctx); /* This sets ctx->last_pkt to NULL.  */
   iobuf_skip_rest (inp, pktlen, 0);
   return err;
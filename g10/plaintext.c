@@ -584,11 +584,18 @@ do_hash (gcry_md_hd_t md, gcry_md_hd_t md2, IOBUF fp, int textmode)
     }
   else
     {
-      while ((c = iobuf_get (fp)) != -1)
+      /* Read in chunks of the iobuf buffer size so that the file
+       * filter can read directly into our buffer.  */
+      size_t size = iobuf_set_buffer_size (0) * 1024;
+      byte *buffer = xmalloc (size);
+      int len;
+
+      while ((len = iobuf_read (fp, buffer, size)) != -1)
 	{
 	  if (md)
-	    gcry_md_putc (md, c);
+	    gcry_md_write (md, buffer, len);
 	}
+      xfree (buffer);
     }
 }
 
@@ -67,6 +67,43 @@ is_algo_in_prefs (kbnode_t keyblock, preftype_t type, int algo)
 }
 
 
+/* Return true if the encrypted session key ENC may have been created
+ * for the public key SK.  This is a cheap test used to skip keys when
+ * trying the secret keys for a hidden recipient; each attempt costs a
+ * round trip to the agent and possibly a passphrase prompt.  The
+ * values are smaller than the modulus for RSA and Elgamal and for
+ * ECDH the ephemeral point has the same encoding as the public point
+ * of the recipient's curve.  */
+static int
+enc_fits_key (struct pubkey_enc_list *enc, PKT_public_key *sk)
+{
+  unsigned int nbits;
+
+  if (!enc->data[0] || !sk->pkey[0] || !sk->pkey[1])
+    return 1;  /* Let get_it figure out what's wrong.  */
+
+  switch (sk->pubkey_algo)
+    {
+    case PUBKEY_ALGO_RSA:
+    case PUBKEY_ALGO_RSA_E:
+      return mpi_get_nbits (enc->data[0]) <= mpi_get_nbits (sk->pkey[0]);
+
+    case PUBKEY_ALGO_ELGAMAL:
+    case PUBKEY_ALGO_ELGAMAL_E:
+      nbits = mpi_get_nbits (sk->pkey[0]);
+      return (mpi_get_nbits (enc->data[0]) <= nbits
+              && (!enc->data[1] || mpi_get_nbits (enc->data[1]) <= nbits));
+
+    case PUBKEY_ALGO_ECDH:
+      return ((mpi_get_nbits (enc->data[0]) + 7) / 8
+              == (mpi_get_nbits (sk->pkey[1]) + 7) / 8);
+
+    default:
+      return 1;
+    }
+}
+
+
 /*
  * Get the session key from a pubkey enc packet and return it in DEK,
  * which should have been allocated in secure memory by the caller.
@@ -138,12 +175,16 @@ get_session_key (ctrl_t ctrl, struct pubkey_enc_list *list, DEK *dek)
               if (opt.skip_hidden_recipients)
                 continue;
 
+              if (!enc_fits_key (k, sk))
+                continue;
+
               if (!opt.quiet)
                 log_info (_("anonymous recipient; trying secret key %s ...\n"),
                           keystr (keyid));
             }
-          else if (opt.try_all_secrets
-                   || (k->keyid[0] == keyid[0] && k->keyid[1] == keyid[1]))
+          else if (k->keyid[0] == keyid[0] && k->keyid[1] == keyid[1])
+            ;
+          else if (opt.try_all_secrets && enc_fits_key (k, sk))
             ;
           else
             continue;
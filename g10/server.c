@@ -51,6 +51,9 @@ struct server_local_s
   /* List of prepared recipients.  */
   pk_list_t recplist;
 
+  /* List of signers as set by the SIGNER command.  */
+  strlist_t signerlist;
+
   /* Set if pinentry notifications should be passed back to the
      client. */
   int allow_pinentry_notify;
@@ -58,6 +61,64 @@ struct server_local_s
 
 
 
+/* Note that it is sufficient to allocate the target string D as
+   long as the source string S, i.e.: strlen(s)+1; */
+static void
+strcpy_escaped_plus (char *d, const char *s)
+{
+  while (*s)
+    {
+      if (*s == '%' && s[1] && s[2])
+        {
+          s++;
+          *d++ = xtoi_2 (s);
+          s += 2;
+        }
+      else if (*s == '+')
+        *d++ = ' ', s++;
+      else
+        *d++ = *s++;
+    }
+  *d = 0;
+}
+
+
+/* Break down LINE into a list of percent-plus unescaped strings and
+   store it at R_LIST.  */
+static gpg_error_t
+line_to_strlist (char *line, strlist_t *r_list)
+{
+  char *p;
+  strlist_t list, sl;
+
+  *r_list = NULL;
+  list = NULL;
+  for (p=line; *p; line = p)
+    {
+      while (*p && *p != ' ')
+        p++;
+      if (*p)
+        *p++ = 0;
+      if (*line)
+        {
+          sl = xtrymalloc (sizeof *sl + strlen (line));
+          if (!sl)
+            {
+              gpg_error_t err = gpg_error_from_syserror ();
+              free_strlist (list);
+              return err;
+            }
+          sl->flags = 0;
+          strcpy_escaped_plus (sl->d, line);
+          sl->next = list;
+          list = sl;
+        }
+    }
+  *r_list = list;
+  return 0;
+}
+
+
 /* Helper to close the message fd if it is open. */
 static void
 close_message_fd (ctrl_t ctrl)
@@ -126,6 +187,8 @@ reset_notify (assuan_context_t ctx, char *line)
 
   release_pk_list (ctrl->server_local->recplist);
   ctrl->server_local->recplist = NULL;
+  free_strlist (ctrl->server_local->signerlist);
+  ctrl->server_local->signerlist = NULL;
 
   close_message_fd (ctrl);
   assuan_close_input_fd (ctx);
@@ -234,9 +297,34 @@ cmd_recipient (assuan_context_t ctx, char *line)
 static gpg_error_t
 cmd_signer (assuan_context_t ctx, char *line)
 {
-  (void)ctx;
-  (void)line;
-  return gpg_error (GPG_ERR_NOT_SUPPORTED);
+  ctrl_t ctrl = assuan_get_pointer (ctx);
+  gpg_error_t err;
+  strlist_t sl = NULL;
+  SK_LIST sk_list = NULL;
+
+  line = skip_options (line);
+  if (!*line)
+    return set_error (GPG_ERR_ASS_PARAMETER, "no user ID given");
+
+  /* Check the key now so that the client gets an error right away;
+     build_sk_list also emits the INV_SGNR status.  */
+  add_to_strlist (&sl, line);
+  err = build_sk_list (ctrl, sl, &sk_list, PUBKEY_USAGE_SIG);
+  release_sk_list (sk_list);
+  if (!err)
+    {
+      /* Keep the order of the SIGNER commands like --local-user.  */
+      if (ctrl->server_local->signerlist)
+        strlist_last (ctrl->server_local->signerlist)->next = sl;
+      else
+        ctrl->server_local->signerlist = sl;
+    }
+  else
+    {
+      free_strlist (sl);
+      log_error ("command '%s' failed: %s\n", "SIGNER", gpg_strerror (err));
+    }
+  return err;
 }
 
 
@@ -428,9 +516,32 @@ cmd_verify (assuan_context_t ctx, char *line)
 static gpg_error_t
 cmd_sign (assuan_context_t ctx, char *line)
 {
-  (void)ctx;
-  (void)line;
-  return gpg_error (GPG_ERR_NOT_SUPPORTED);
+  ctrl_t ctrl = assuan_get_pointer (ctx);
+  gpg_error_t err;
+  int inp_fd, out_fd;
+  int detached;
+
+  detached = has_option (line, "--detached");
+
+  inp_fd = translate_sys2libc_fd (assuan_get_input_fd (ctx), 0);
+  if (inp_fd == -1)
+    return set_error (GPG_ERR_ASS_NO_INPUT, NULL);
+  out_fd = translate_sys2libc_fd (assuan_get_output_fd (ctx), 1);
+  if (out_fd == -1)
+    return set_error (GPG_ERR_ASS_NO_OUTPUT, NULL);
+
+  /* Without a SIGNER command the default key is used.  */
+  err = sign_file_fd (ctrl, inp_fd, out_fd, detached,
+                      ctrl->server_local->signerlist);
+
+  /* Close and reset the fds. */
+  close_message_fd (ctrl);
+  assuan_close_input_fd (ctx);
+  assuan_close_output_fd (ctx);
+
+  if (err)
+    log_error ("command '%s' failed: %s\n", "SIGN", gpg_strerror (err));
+  return err;
 }
 
 
@@ -442,43 +553,128 @@ cmd_sign (assuan_context_t ctx, char *line)
 static gpg_error_t
 cmd_import (assuan_context_t ctx, char *line)
 {
-  (void)ctx;
-  (void)line;
-  return gpg_error (GPG_ERR_NOT_SUPPORTED);
+  ctrl_t ctrl = assuan_get_pointer (ctx);
+  gpg_error_t err;
+  int inp_fd;
+  estream_t fp;
+  import_stats_t stats;
+
+  (void)line; /* LINE is not used.  */
+
+  inp_fd = translate_sys2libc_fd (assuan_get_input_fd (ctx), 0);
+  if (inp_fd == -1)
+    return set_error (GPG_ERR_ASS_NO_INPUT, NULL);
+
+  fp = es_fdopen_nc (inp_fd, "rb");
+  if (!fp)
+    err = set_error (gpg_err_code_from_syserror (), "fdopen() failed");
+  else
+    {
+      stats = import_new_stats_handle ();
+      err = import_keys_es_stream (ctrl, fp, stats, NULL, NULL,
+                                   opt.import_options, NULL, NULL,
+                                   KEYORG_UNKNOWN, NULL);
+      import_print_stats (stats);
+      import_release_stats_handle (stats);
+      es_fclose (fp);
+    }
+
+  /* Close and reset the fds. */
+  close_message_fd (ctrl);
+  assuan_close_input_fd (ctx);
+  assuan_close_output_fd (ctx);
+
+  if (err)
+    log_error ("command '%s' failed: %s\n", "IMPORT", gpg_strerror (err));
+  return err;
 }
 
 
 
-/*  EXPORT [--data [--armor|--base64]] [--] pattern
+/*  EXPORT [--] <patterns>
 
    Similar to the --export command line command, this command exports
-   public keys matching PATTERN.  The output is send to the output fd
-   unless the --data option has been used in which case the output
-   gets send inline using regular data lines.  The options "--armor"
-   and "--base" ospecify an output format if "--data" has been used.
-   Recall that in general the output format is set with the OUTPUT
-   command.
+   public keys matching PATTERNS.  Each pattern shall be a
+   percent-plus escaped user ID.  The output is send to the output fd;
+   it is armored if the server has been started with --armor.  The
+   "--data" mode to send the output inline is not yet supported.
  */
 static gpg_error_t
 cmd_export (assuan_context_t ctx, char *line)
 {
-  (void)ctx;
-  (void)line;
-  return gpg_error (GPG_ERR_NOT_SUPPORTED);
+  ctrl_t ctrl = assuan_get_pointer (ctx);
+  gpg_error_t err;
+  int out_fd;
+  strlist_t list;
+  export_stats_t stats;
+
+  if (has_option (line, "--data"))
+    return set_error (GPG_ERR_NOT_SUPPORTED, "option --data");
+  line = skip_options (line);
+
+  out_fd = translate_sys2libc_fd (assuan_get_output_fd (ctx), 1);
+  if (out_fd == -1)
+    return set_error (GPG_ERR_ASS_NO_OUTPUT, NULL);
+
+  err = line_to_strlist (line, &list);
+  if (!err)
+    {
+      stats = export_new_stats ();
+      err = export_pubkeys_fd (ctrl, list, out_fd, opt.export_options, stats);
+      export_print_stats (stats);
+      export_release_stats (stats);
+      free_strlist (list);
+    }
+
+  /* Close and reset the fds. */
+  close_message_fd (ctrl);
+  assuan_close_input_fd (ctx);
+  assuan_close_output_fd (ctx);
+
+  if (err)
+    log_error ("command '%s' failed: %s\n", "EXPORT", gpg_strerror (err));
+  return err;
 }
 
 
 
-/*  DELKEYS
+/*  DELKEYS [--secret] [--allow-both] [--] <patterns>
 
-    Fixme
-*/
+    Delete the keys specified by PATTERNS.  Each pattern shall be a
+    percent-plus escaped key specification.  Because the server runs
+    in batch mode only fingerprints are accepted.  With "--secret"
+    the secret keys are deleted; "--allow-both" deletes the secret and
+    the public keys.  */
 static gpg_error_t
 cmd_delkeys (assuan_context_t ctx, char *line)
 {
-  (void)ctx;
-  (void)line;
-  return gpg_error (GPG_ERR_NOT_SUPPORTED);
+  ctrl_t ctrl = assuan_get_pointer (ctx);
+  gpg_error_t err;
+  strlist_t list;
+  int secret, allow_both;
+
+  secret = has_option (line, "--secret");
+  allow_both = has_option (line, "--allow-both");
+  line = skip_options (line);
+
+  err = line_to_strlist (line, &list);
+  if (!err)
+    {
+      if (!list)
+        err = set_error (GPG_ERR_NO_USER_ID, "no key given");
+      else
+        err = delete_keys (ctrl, list, secret, allow_both);
+      free_strlist (list);
+    }
+
+  /* Close and reset the fds. */
+  close_message_fd (ctrl);
+  assuan_close_input_fd (ctx);
+  assuan_close_output_fd (ctx);
+
+  if (err)
+    log_error ("command '%s' failed: %s\n", "DELKEYS", gpg_strerror (err));
+  return err;
 }
 
 
@@ -508,7 +704,8 @@ cmd_message (assuan_context_t ctx, char *line)
 /* LISTKEYS [<patterns>]
    LISTSECRETKEYS [<patterns>]
 
-   fixme
+   Not yet supported: The key listing code writes to es_stdout which
+   is the Assuan connection in server mode.
 */
 static gpg_error_t
 do_listkeys (assuan_context_t ctx, char *line, int mode)
@@ -753,6 +950,7 @@ gpg_server (ctrl_t ctrl)
   if (ctrl->server_local)
     {
       release_pk_list (ctrl->server_local->recplist);
+      free_strlist (ctrl->server_local->signerlist);
 
       xfree (ctrl->server_local);
       ctrl->server_local = NULL;
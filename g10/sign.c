@@ -49,6 +49,10 @@
 #define LF "\n"
 #endif
 
+/* The number of bytes to skip at once when reading a file only for
+ * the md_filter to hash it.  */
+#define DRAIN_SIZE (1024*1024)
+
 /* Hack */
 static int recipient_digest_algo;
 
@@ -878,10 +882,14 @@ write_signature_packets (ctrl_t ctrl,
  * If OUTFILE is not NULL; this file is used for output and the function
  * does not ask for overwrite permission; output is then always
  * uncompressed, non-armored and in binary mode.
+ * If INP_FD is not -1 the data is read from that file descriptor
+ * instead of FILENAMES; if OUT_FD is not -1 the output is written to
+ * that file descriptor.
  */
-int
-sign_file (ctrl_t ctrl, strlist_t filenames, int detached, strlist_t locusr,
-	   int encryptflag, strlist_t remusr, const char *outfile )
+static int
+do_sign_file (ctrl_t ctrl, strlist_t filenames, int inp_fd, int out_fd,
+              int detached, strlist_t locusr,
+              int encryptflag, strlist_t remusr, const char *outfile )
 {
   const char *fname;
   armor_filter_context_t *afx;
@@ -943,7 +951,10 @@ sign_file (ctrl_t ctrl, strlist_t filenames, int detached, strlist_t locusr,
     inp = NULL;     /* we do it later */
   else
     {
-      inp = iobuf_open(fname);
+      if (inp_fd != -1)
+        inp = iobuf_fdopen_nc (inp_fd, "rb");
+      else
+        inp = iobuf_open(fname);
       if (inp && is_secured_file (iobuf_get_fd (inp)))
         {
           iobuf_close (inp);
@@ -979,7 +990,7 @@ sign_file (ctrl_t ctrl, strlist_t filenames, int detached, strlist_t locusr,
       else if (opt.verbose)
         log_info (_("writing to '%s'\n"), outfile);
     }
-  else if ((rc = open_outfile (-1, fname,
+  else if ((rc = open_outfile (out_fd, fname,
                                opt.armor? 1 : detached? 2 : 0, 0, &out)))
     {
       goto leave;
@@ -1180,7 +1191,7 @@ sign_file (ctrl_t ctrl, strlist_t filenames, int detached, strlist_t locusr,
                   iobuf_push_filter (inp, text_filter, &tfx);
                 }
               iobuf_push_filter (inp, md_filter, &mfx);
-              while (iobuf_get (inp) != -1)
+              while (iobuf_read (inp, NULL, DRAIN_SIZE) != -1)
                 ;
               iobuf_close (inp);
               inp = NULL;
@@ -1191,7 +1202,7 @@ sign_file (ctrl_t ctrl, strlist_t filenames, int detached, strlist_t locusr,
       else
         {
           /* Read, so that the filter can calculate the digest. */
-          while (iobuf_get(inp) != -1)
+          while (iobuf_read (inp, NULL, DRAIN_SIZE) != -1)
             ;
 	}
     }
@@ -1236,6 +1247,34 @@ sign_file (ctrl_t ctrl, strlist_t filenames, int detached, strlist_t locusr,
 }
 
 
+/*
+ * Sign the files whose names are in FILENAME.  See do_sign_file for
+ * a description of the arguments.
+ */
+int
+sign_file (ctrl_t ctrl, strlist_t filenames, int detached, strlist_t locusr,
+	   int encryptflag, strlist_t remusr, const char *outfile )
+{
+  return do_sign_file (ctrl, filenames, -1, -1, detached, locusr,
+                       encryptflag, remusr, outfile);
+}
+
+
+/*
+ * Sign the data read from INP_FD and write the signature to OUT_FD
+ * using the secret keys from LOCUSR or the default key.  If DETACHED
+ * is set a detached signature is created.  This is used by the
+ * server.
+ */
+int
+sign_file_fd (ctrl_t ctrl, int inp_fd, int out_fd, int detached,
+              strlist_t locusr)
+{
+  return do_sign_file (ctrl, NULL, inp_fd, out_fd, detached, locusr,
+                       0, NULL, NULL);
+}
+
+
 /*
  * Make a clear signature.  Note that opt.armor is not needed.
  */
@@ -35,6 +35,161 @@
 #include "filter.h"
 #include "../common/ttyio.h"
 #include "../common/i18n.h"
+#include "../common/membuf.h"
+
+
+/* The maximum total size of the signature files read with
+ * --signed-data.  Detached signatures are small; this only guards
+ * against a large file given by mistake.  */
+#define MAX_SIGFILES_SIZE (1024*1024)
+
+/* Check that the LEN bytes at BUF read from the file FNAME consist
+ * only of signature packets of the same class.  *R_CLASS has the
+ * class of the signatures seen so far or -1; it is updated.  The
+ * code handling detached signatures checks only the first signature
+ * if the classes differ; thus we reject this here.  */
+static gpg_error_t
+check_sigfile (const char *fname, const void *buf, size_t len, int *r_class)
+{
+  gpg_error_t err;
+  iobuf_t a;
+  struct parse_packet_ctx_s parsectx;
+  PACKET *pkt;
+  int save_mode;
+
+  pkt = xtrymalloc (sizeof *pkt);
+  if (!pkt)
+    return gpg_error_from_syserror ();
+  a = iobuf_temp_with_content (buf, len);
+  init_packet (pkt);
+  init_parse_packet (&parsectx, a);
+  save_mode = set_packet_list_mode (0);
+  while ((err = parse_packet (&parsectx, pkt)) != -1)
+    {
+      if (!err && pkt->pkttype != PKT_SIGNATURE)
+        {
+          log_error (_("'%s' is not a detached signature\n"),
+                     print_fname_stdin (fname));
+          err = gpg_error (GPG_ERR_UNEXPECTED_TAG);
+        }
+      else if (!err && *r_class != -1
+               && pkt->pkt.signature->sig_class != *r_class)
+        {
+          log_error (_("'%s': signature class 0x%02x differs from 0x%02x\n"),
+                     print_fname_stdin (fname),
+                     pkt->pkt.signature->sig_class, *r_class);
+          err = gpg_error (GPG_ERR_SIG_CLASS);
+        }
+      else if (!err)
+        *r_class = pkt->pkt.signature->sig_class;
+      else
+        log_error (_("error reading '%s': %s\n"),
+                   print_fname_stdin (fname), gpg_strerror (err));
+      free_packet (pkt, &parsectx);
+      init_packet (pkt);
+      if (err)
+        break;
+    }
+  if (err == -1)
+    err = 0;
+  set_packet_list_mode (save_mode);
+  deinit_parse_packet (&parsectx);
+  iobuf_close (a);
+  xfree (pkt);
+  return err;
+}
+
+
+/* Read the detached signatures from the NFILES files in FILES and
+ * return them as one packet stream at R_FP.  The armor is removed
+ * from each file on its own so that binary and armored signatures can
+ * be mixed.  This allows checking all signatures with a single pass
+ * over the signed data.  */
+static gpg_error_t
+read_sigfiles (int nfiles, char **files, iobuf_t *r_fp)
+{
+  gpg_error_t err = 0;
+  membuf_t mb, fmb;
+  iobuf_t fp;
+  armor_filter_context_t *afx;
+  byte buffer[4096];
+  char *p;
+  size_t len, total = 0;
+  int i, n;
+  int sigclass = -1;
+
+  *r_fp = NULL;
+  init_membuf (&mb, 4096);
+
+  for (i=0; i < nfiles && !err; i++)
+    {
+      fp = iobuf_open (files[i]);
+      if (fp && is_secured_file (iobuf_get_fd (fp)))
+        {
+          iobuf_close (fp);
+          fp = NULL;
+          gpg_err_set_errno (EPERM);
+        }
+      if (!fp)
+        {
+          err = gpg_error_from_syserror ();
+          log_error (_("can't open '%s': %s\n"),
+                     print_fname_stdin (files[i]), gpg_strerror (err));
+          break;
+        }
+
+      afx = NULL;
+      if (!opt.no_armor && use_armor_filter (fp))
+        {
+          afx = new_armor_context ();
+          push_armor_filter (afx, fp);
+        }
+
+      init_membuf (&fmb, 1024);
+      while ((n = iobuf_read (fp, buffer, sizeof buffer)) != -1)
+        {
+          total += n;
+          if (total > MAX_SIGFILES_SIZE)
+            break;
+          put_membuf (&fmb, buffer, n);
+        }
+      err = iobuf_error (fp);
+      if (!err && total > MAX_SIGFILES_SIZE)
+        err = gpg_error (GPG_ERR_TOO_LARGE);
+      if (err)
+        log_error (_("error reading '%s': %s\n"),
+                   print_fname_stdin (files[i]), gpg_strerror (err));
+      iobuf_close (fp);
+      release_armor_context (afx);
+
+      p = get_membuf (&fmb, &len);
+      if (!p)
+        {
+          if (!err)
+            err = gpg_error_from_syserror ();
+          break;
+        }
+      if (!err)
+        err = check_sigfile (files[i], p, len, &sigclass);
+      if (!err)
+        put_membuf (&mb, p, len);
+      xfree (p);
+    }
+
+  p = get_membuf (&mb, &len);
+  if (!p)
+    {
+      if (!err)
+        err = gpg_error_from_syserror ();
+      return err;
+    }
+  if (!err && !len)
+    err = gpg_error (GPG_ERR_NO_DATA);
+  if (!err)
+    *r_fp = iobuf_temp_with_content (p, len);
+  xfree (p);
+  return err;
+}
 
 
 /****************
@@ -45,6 +200,8 @@
  * signature or a detached signature in which case the signed stuff
  * is expected from stdin. With more than 1 argument, the first should
  * be a detached signature and the remaining files are the signed stuff.
+ * With --signed-data all arguments are detached signatures for the
+ * file given with that option.
  */
 
 int
@@ -83,6 +240,34 @@ verify_signatures (ctrl_t ctrl, int nfiles, char **files )
 
     sigfile = nfiles? *files : NULL;
 
+    if (opt.signed_data && !nfiles)
+      {
+        log_error (_("option '%s' requires a signature file\n"),
+                   "--signed-data");
+        rc = gpg_error (GPG_ERR_INV_ARG);
+        goto leave;
+      }
+    if (opt.signed_data)
+      {
+        /* All arguments are signature files; put them into one
+         * stream so that the data is hashed only once.  */
+        rc = read_sigfiles (nfiles, files, &fp);
+        if (!rc)
+          {
+            sl = NULL;
+            add_to_strlist (&sl, opt.signed_data);
+            rc = proc_signature_packets (ctrl, NULL, fp, sl, sigfile);
+            free_strlist (sl);
+            iobuf_close (fp);
+          }
+        if (gpg_err_code (rc) == GPG_ERR_NO_DATA)
+          {
+            log_error (_("the signature could not be verified.\n"));
+            rc = 0;
+          }
+        goto leave;
+      }
+
     /* open the signature file */
     fp = iobuf_open(sigfile);
     if (fp && is_secured_file (iobuf_get_fd (fp)))
@@ -41,6 +41,11 @@ struct sn_array_s {
 };
 
 
+/* The size of the stdio buffer used for searching.  A search reads
+   the keybox sequentially and often in full; the default buffer of
+   the size of one disk block results in lots of small reads.  */
+#define SEARCH_BUFFER_SIZE (64*1024)
+
 #define get32(a) buf32_to_ulong ((a))
 #define get16(a) buf16_to_ulong ((a))
 
@@ -817,6 +822,8 @@ open_file (KEYBOX_HANDLE hd)
       hd->error = gpg_error_from_syserror ();
       return hd->error;
     }
+  /* A failure here is not a problem; stdio then uses its default.  */
+  setvbuf (hd->fp, NULL, _IOFBF, SEARCH_BUFFER_SIZE);
 
   return 0;
 }
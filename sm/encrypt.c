@@ -165,12 +165,13 @@ encode_session_key (DEK dek, gcry_sexp_t * r_data)
 }
 
 
-/* Encrypt the DEK under the key contained in CERT and return it as a
-   canonical S-Exp in encval. */
+/* Encrypt the session key S_DATA as returned by encode_session_key
+   under the key contained in CERT and return it as a canonical S-Exp
+   in encval. */
 static int
-encrypt_dek (const DEK dek, ksba_cert_t cert, unsigned char **encval)
+encrypt_dek (gcry_sexp_t s_data, ksba_cert_t cert, unsigned char **encval)
 {
-  gcry_sexp_t s_ciph, s_data, s_pkey;
+  gcry_sexp_t s_ciph, s_pkey;
   int rc;
   ksba_sexp_t buf;
   size_t len;
@@ -198,18 +199,8 @@ encrypt_dek (const DEK dek, ksba_cert_t cert, unsigned char **encval)
       return rc;
     }
 
-  /* Put the encoded cleartext into a simple list. */
-  s_data = NULL; /* (avoid compiler warning) */
-  rc = encode_session_key (dek, &s_data);
-  if (rc)
-    {
-      log_error ("encode_session_key failed: %s\n", gpg_strerror (rc));
-      return rc;
-    }
-
   /* pass it to libgcrypt */
   rc = gcry_pk_encrypt (&s_ciph, s_data, s_pkey);
-  gcry_sexp_release (s_data);
   gcry_sexp_release (s_pkey);
 
   /* Reformat it. */
@@ -309,6 +300,7 @@ gpgsm_encrypt (ctrl_t ctrl, certlist_t recplist, int data_fd, estream_t out_fp)
   KEYDB_HANDLE kh = NULL;
   struct encrypt_cb_parm_s encparm;
   DEK dek = NULL;
+  gcry_sexp_t s_data = NULL;
   int recpno;
   estream_t data_fp = NULL;
   certlist_t cl;
@@ -470,6 +462,15 @@ gpgsm_encrypt (ctrl_t ctrl, certlist_t recplist, int data_fd, estream_t out_fp)
   compliant = gnupg_cipher_is_compliant (CO_DE_VS, dek->algo,
                                          GCRY_CIPHER_MODE_CBC);
 
+  /* Put the encoded cleartext into a simple list.  This is the same
+     for all recipients; the padding is added by libgcrypt.  */
+  rc = encode_session_key (dek, &s_data);
+  if (rc)
+    {
+      log_error ("encode_session_key failed: %s\n", gpg_strerror (rc));
+      goto leave;
+    }
+
   /* Gather certificates of recipients, encrypt the session key for
      each and store them in the CMS object */
   for (recpno = 0, cl = recplist; cl; recpno++, cl = cl->next)
@@ -498,7 +499,7 @@ gpgsm_encrypt (ctrl_t ctrl, certlist_t recplist, int data_fd, estream_t out_fp)
           && !gnupg_pk_is_compliant (CO_DE_VS, pk_algo, NULL, nbits, NULL))
         compliant = 0;
 
-      rc = encrypt_dek (dek, cl->cert, &encval);
+      rc = encrypt_dek (s_data, cl->cert, &encval);
       if (rc)
         {
           audit_log_cert (ctrl->audit, AUDIT_ENCRYPTED_TO, cl->cert, rc);
@@ -566,6 +567,7 @@ gpgsm_encrypt (ctrl_t ctrl, certlist_t recplist, int data_fd, estream_t out_fp)
   log_info ("encrypted data created\n");
 
  leave:
+  gcry_sexp_release (s_data);
   ksba_cms_release (cms);
   gnupg_ksba_destroy_writer (b64writer);
   ksba_reader_release (reader);
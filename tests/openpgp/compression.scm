@@ -34,3 +34,21 @@
        (tr:assert-identity source)))
     (append plain-files data-files)))
  (force all-compression-algos))
+
+(for-each-p
+ "Checking that incompressible data is stored"
+ (lambda (compression)
+   (lettmp (source encrypted)
+     (make-test-data source (* 1024 1024))
+     (let ((status (call-popen `(,@GPG --status-fd=1 --yes --output ,encrypted
+				       --encrypt --recipient ,usrname2
+				       --compress-algo ,compression ,source)
+			       "")))
+       (unless (string-contains? status "[GNUPG:] COMPRESS_STORED ")
+	       (fail "No COMPRESS_STORED status for random data" status)))
+     (tr:do
+      (tr:open encrypted)
+      (tr:gpg "" '(--yes --decrypt))
+      (tr:assert-identity source))))
+ (filter (lambda (x) (member x '("ZIP" "ZLIB")))
+	 (force all-compression-algos)))
@@ -98,3 +98,23 @@
 
     (assert-passphrases-consumed))
   '("D74C5F22" "C40FDECF" "ECABF51D")))
+
+(info "Checking that exporting all keys matches exporting each key")
+(call-check `(,@GPG --import ,(in-srcdir "tests" "openpgp" "samplekeys"
+					 "sensitive-revkey.asc")))
+(call-check `(,@GPG --local-user ,dsa-usrname1
+		    --quick-lsign-key 70F6C483CA2784892F677834843ECC18EC19CBAE))
+(let ((keyids (map (lambda (l) (list-ref l 4))
+		   (filter (lambda (l) (equal? 'pub (:type l)))
+			   (gpg-with-colons '(--list-keys))))))
+  (for-each
+   (lambda (options)
+     ;; Without user ids the keyblocks are copied from the keybox.
+     (unless (string=? (call-popen `(,@GPG --armor ,@options --export) "")
+		       (call-popen `(,@GPG --armor ,@options --export
+					   ,@keyids) ""))
+	     (fail "Exporting all keys differs for options" options)))
+   '(()
+     (--export-options export-local-sigs)
+     (--export-options export-sensitive-revkeys)
+     (--export-options export-local-sigs,export-sensitive-revkeys))))
@@ -0,0 +1,104 @@
+#!/usr/bin/env gpgscm
+
+;; Copyright (C) 2026 g10 Code GmbH
+;;
+;; This file is part of GnuPG.
+;;
+;; GnuPG is free software; you can redistribute it and/or modify
+;; it under the terms of the GNU General Public License as published by
+;; the Free Software Foundation; either version 3 of the License, or
+;; (at your option) any later version.
+;;
+;; GnuPG is distributed in the hope that it will be useful,
+;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;; GNU General Public License for more details.
+;;
+;; You should have received a copy of the GNU General Public License
+;; along with this program; if not, see <http://www.gnu.org/licenses/>.
+
+(load (in-srcdir "tests" "openpgp" "defs.scm"))
+(setup-legacy-environment)
+
+;; Run the Assuan commands in SCRIPT against "gpg --server" and return
+;; the responses as a list of 'ok and 'err symbols.  The file
+;; descriptors for INPUT and OUTPUT are passed using /sendfd.
+(define (gpg-server script)
+  (let ((out (call-popen `(,(tool 'gpg-connect-agent) --exec --
+			   ,@GPG --server)
+			 (string-append script "/bye\n"))))
+    (map (lambda (l) (if (string-prefix? l "OK") 'ok 'err))
+	 (filter (lambda (l) (or (string-prefix? l "OK")
+				 (string-prefix? l "ERR")))
+		 (string-split-newlines out)))))
+
+(define (check-server script expected)
+  (let ((responses (gpg-server script)))
+    (unless (equal? responses expected)
+	    (fail "Unexpected responses" responses "to" script))))
+
+;; Return the key ids of the signatures in FILE in order.
+(define (signature-keyids file)
+  (map (lambda (l) (string-split l #\space))
+       (filter (lambda (l) (string-prefix? l ":signature packet:"))
+	       (string-split-newlines
+		(call-popen `(,@GPG --list-packets ,file) "")))))
+
+(define fpr "94FF636D71BD63099E079A0D4CB1EB7A1496C99B")
+
+(define (have-key?)
+  (= 0 (call `(,@GPG --list-keys ,fpr))))
+
+(info "Checking SIGNER and SIGN")
+(lettmp (sig sig2)
+  (check-server (string-append "/sendfd data-500 r\n"
+			       "INPUT FD\n"
+			       "/sendfd " sig " w\n"
+			       "OUTPUT FD\n"
+			       "SIGNER " dsa-usrname1 "\n"
+			       "SIGNER " usrname1 "\n"
+			       "SIGN --detached\n")
+		'(ok ok ok ok ok))
+  (call-check `(,@GPG --verify ,sig data-500))
+  ;; The signatures are made in the order of the SIGNER commands.
+  (call-check `(,@GPG --yes --detach-sign --output ,sig2
+		      --local-user ,dsa-usrname1 --local-user ,usrname1
+		      data-500))
+  (unless (equal? (signature-keyids sig) (signature-keyids sig2))
+	  (fail "Signers not used in the order given")))
+
+(info "Checking errors of SIGNER and SIGN")
+(check-server "SIGNER no-such-key@example.org\n" '(err))
+(check-server "SIGN\n" '(err))
+(check-server "/sendfd data-500 r\nINPUT FD\nSIGN\n" '(ok err))
+
+(info "Checking IMPORT, EXPORT and DELKEYS")
+(lettmp (exported)
+  (check-server (string-append "/sendfd "
+			       (in-srcdir "tests" "openpgp" "samplekeys"
+					  "reimport-1.asc")
+			       " r\n"
+			       "INPUT FD\n"
+			       "IMPORT\n")
+		'(ok ok))
+  (unless (have-key?)
+	  (fail "Key not imported"))
+  (check-server (string-append "/sendfd " exported " w\n"
+			       "OUTPUT FD\n"
+			       "EXPORT " fpr "\n")
+		'(ok ok))
+  (check-server (string-append "DELKEYS " fpr "\n") '(ok))
+  (when (have-key?)
+	(fail "Key not deleted"))
+  (check-server (string-append "DELKEYS " fpr "\n") '(err))
+  (check-server (string-append "/sendfd " exported " r\n"
+			       "INPUT FD\n"
+			       "IMPORT\n")
+		'(ok ok))
+  (unless (have-key?)
+	  (fail "Exported key not imported")))
+
+(info "Checking errors of IMPORT, EXPORT and DELKEYS")
+(check-server "IMPORT\n" '(err))
+(check-server (string-append "EXPORT " fpr "\n") '(err))
+(check-server "DELKEYS\n" '(err))
@@ -39,6 +39,37 @@
 	 (fail "no error code from verify"))))
  '("#x2d" "#xca"))
 
+;; A signature with a zero-length subpacket in the hashed area
+;; followed by an octet which looks like a creation time subpacket.
+(define sig-zero-len-subpkt "-----BEGIN PGP SIGNATURE-----
+
+iBkEAAEIAAIAAgAKCRA0t9ELwQjoOhI0AAj/
+=Ngbl
+-----END PGP SIGNATURE-----
+")
+
+;; A signature with a zero-length subpacket in the hashed area which
+;; is followed by a valid creation time subpacket.
+(define sig-zero-len-subpkt-2 "-----BEGIN PGP SIGNATURE-----
+
+iB4EAAEIAAcABQJaAAAAAAoJEDS30QvBCOg6EjQACP8=
+=tWZG
+-----END PGP SIGNATURE-----
+")
+
+(info "Checking signatures with a zero-length subpacket")
+(unless (string-contains? (call-popen `(,@gpg --list-packets)
+				      sig-zero-len-subpkt)
+			  "created 0,")
+	(fail "zero-length subpacket was used as creation time"))
+(if (= 0 (:retcode (call-with-io `(,@gpgv --keyring ,keyring - data-500)
+				  sig-zero-len-subpkt)))
+    (fail "no error code from verify"))
+(unless (string-contains? (call-popen `(,@gpg --list-packets)
+				      sig-zero-len-subpkt-2)
+			  "created 1509949440,")
+	(fail "creation time after a zero-length subpacket not found"))
+
 ;; Fixme:  We need more tests with manipulated cleartext signatures.
 
 ;;
@@ -73,3 +104,28 @@
     (pipe:echo (eval armored-file (current-environment)))
     (pipe:spawn `(,@gpgv --keyring ,keyring))))
  '(msg_ed25519_rshort msg_ed25519_sshort))
+
+(info "Checking --signed-data with binary and armored signatures")
+(lettmp (sig1 sig2 sig3)
+  (call-check `(,@gpg --yes --detach-sign --user ,dsa-usrname1
+		      --output ,sig1 data-500))
+  (call-check `(,@gpg --yes --detach-sign --armor --user ,dsa-usrname1
+		      --output ,sig2 data-500))
+  (call-check `(,@gpg --yes --detach-sign --armor --textmode
+		      --user ,dsa-usrname1 --output ,sig3 data-500))
+  (let ((status (call-popen `(,@gpgv --keyring ,keyring --status-fd=1
+				     --signed-data data-500 ,sig1 ,sig2) "")))
+    (unless (= 2 (length (filter (lambda (l)
+				   (string-prefix? l "[GNUPG:] GOODSIG "))
+				 (string-split-newlines status))))
+	    (fail "Expected two good signatures" status)))
+  (if (= 0 (call `(,@gpgv --keyring ,keyring
+			  --signed-data data-9000 ,sig1 ,sig2)))
+      (fail "verification against the wrong data succeeded"))
+  (if (= 0 (call `(,@gpgv --keyring ,keyring --signed-data data-500)))
+      (fail "--signed-data without a signature file succeeded"))
+  (if (= 0 (call `(,@gpgv --keyring ,keyring
+			  --signed-data data-500 ,sig1 ,sig3)))
+      (fail "verification of mixed signature classes succeeded"))
+  (if (= 0 (call `(,@gpg --signed-data data-500 --verify-files ,sig1)))
+      (fail "--signed-data was accepted with --verify-files")))
@@ -59,3 +59,74 @@
 		 (string-split-newlines c))))
       (unless (= 2 (length keys))
 	      (fail "Importing keys with long id collision failed"))))))
+
+(define fpr3 "94FF636D71BD63099E079A0D4CB1EB7A1496C99B")
+(define (import-ok-reason file)
+  (let ((status (call-popen `(,@GPG --status-fd=1 --import
+				    ,(in-srcdir "tests" "openpgp" file)) ""))
+	(prefix "[GNUPG:] IMPORT_OK "))
+    (let ((line (filter (lambda (l)
+			  (and (string-prefix? l prefix)
+			       (string-suffix? l fpr3)))
+			(string-split-newlines status))))
+      (if (null? line)
+	  (fail "No IMPORT_OK status line for" file status))
+      (string->number
+       (car (string-split (substring (car line) (string-length prefix)
+				     (string-length (car line)))
+			  #\space))))))
+(define (count-uids)
+  (length (filter (lambda (l) (equal? 'uid (:type l)))
+		  (gpg-with-colons `(--list-keys ,fpr3)))))
+
+(info "Checking re-import of an unchanged key.")
+(call `(,(tool 'gpg) --delete-key --batch --yes ,fpr3))
+(unless (= 1 (import-ok-reason "samplekeys/reimport-1.asc"))
+	(fail "Key not imported as a new key"))
+(unless (= 0 (import-ok-reason "samplekeys/reimport-1.asc"))
+	(fail "Unchanged key has been modified"))
+
+;; Return true if importing FILE with the extra ARGS took the shortcut
+;; via the import digest.
+(define (import-shortcut? file . args)
+  (let ((result (call-with-io `(,@GPG --verbose --verbose ,@args --import
+				      ,(in-srcdir "tests" "openpgp" file))
+			      "")))
+    (unless (= 0 (:retcode result))
+	    (fail "Import failed" (:stderr result)))
+    (string-contains? (:stderr result) "same as last import - not merged")))
+
+(info "Checking that an unchanged key is not merged again.")
+(unless (import-shortcut? "samplekeys/reimport-1.asc")
+	(fail "Re-import of an unchanged key did not use the import digest"))
+(info "Checking that changed import options bypass the import digest.")
+(when (import-shortcut? "samplekeys/reimport-1.asc"
+			"--import-options" "import-local-sigs")
+      (fail "Import with other options used the import digest"))
+(when (import-shortcut? "samplekeys/reimport-1.asc"
+			"--weak-digest" "RIPEMD160")
+      (fail "Import with another weak digest used the import digest"))
+
+(info "Checking re-import of a changed key.")
+(when (= 0 (import-ok-reason "samplekeys/reimport-2.asc"))
+      (fail "Changed key has not been merged"))
+(unless (= 2 (count-uids))
+	(fail "Expected two user IDs after the merge"))
+(unless (= 0 (import-ok-reason "samplekeys/reimport-2.asc"))
+	(fail "Unchanged key has been modified"))
+;; Importing the older keyblock again must not remove anything.
+(unless (= 0 (import-ok-reason "samplekeys/reimport-1.asc"))
+	(fail "Older keyblock modified the key"))
+(unless (= 2 (count-uids))
+	(fail "User ID lost after re-importing the older keyblock"))
+
+(info "Checking that a relabelled self-signature is not taken from the cache.")
+(call `(,(tool 'gpg) --delete-key --batch --yes ,keyid))
+(call-check `(,(tool 'gpg) --import ,(in-srcdir "tests" "openpgp" "bug1223-good.asc")))
+;; This keyblock has a copy of the direct key signature with the class
+;; changed to 0x20 (key revocation).
+(call `(,(tool 'gpg) --import
+	,(in-srcdir "tests" "openpgp" "samplekeys/relabelled-selfsig.asc")))
+(let ((pub (assoc "pub" (gpg-with-colons `(--list-keys ,keyid)))))
+  (if (equal? "r" (list-ref pub 1))
+      (fail "Relabelled self-signature revoked the key")))